@@ -0,0 +1,120 @@
+#include "AdaptiveWait.h"
+
+#include <thread>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace {
+    constexpr int SPIN_BATCH = 16;  // pauses between clock reads
+    constexpr int YIELD_ROUNDS = 8;
+
+    // with one host CPU the thread that would notify needs the CPU the spinner holds
+    bool canSpin() {
+        static const bool multiCpu = std::thread::hardware_concurrency() > 1;
+        return multiCpu;
+    }
+
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+}
+
+SpinTuning::SpinTuning() : budgetNs(canSpin() ? INITIAL_SPIN_NS : 0) {}
+
+void SpinTuning::record(Phase phase, bool notified, std::chrono::nanoseconds gap) {
+    if (!notified) timedOut.fetch_add(1, std::memory_order_relaxed);
+    else if (phase == Phase::Spin) spun.fetch_add(1, std::memory_order_relaxed);
+    else if (phase == Phase::Yield) yielded.fetch_add(1, std::memory_order_relaxed);
+    else parked.fetch_add(1, std::memory_order_relaxed);
+
+    if (!canSpin()) {
+        budgetNs.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    // racing updates from several waiters only lose a sample, which the average tolerates
+    long long target = notified && gap.count() <= MAX_SPIN_NS ? std::min<long long>(2 * gap.count(), MAX_SPIN_NS) : 0;
+    long long budget = budgetNs.load(std::memory_order_relaxed);
+    budget += (target - budget) / 8;
+    budgetNs.store(std::clamp(budget, 0LL, MAX_SPIN_NS), std::memory_order_relaxed);
+}
+
+WaitStats SpinTuning::getStats() const {
+    WaitStats stats;
+    stats.spun = spun.load(std::memory_order_relaxed);
+    stats.yielded = yielded.load(std::memory_order_relaxed);
+    stats.parked = parked.load(std::memory_order_relaxed);
+    stats.timedOut = timedOut.load(std::memory_order_relaxed);
+    stats.spinBudgetNs = budgetNs.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool AdaptiveWait::waitUntil(Ticket ticket, Clock::time_point deadline) {
+    if (notifiedSince(ticket)) return true;
+
+    auto start = Clock::now();
+    auto budget = tuning->getBudget();
+    auto spinUntil = std::min(deadline, start + budget);
+    auto yieldUntil = std::min(deadline, spinUntil + budget);
+    auto phase = SpinTuning::Phase::Spin;
+    bool notified = false;
+
+    while (!notified && Clock::now() < spinUntil) {
+        for (int i = 0; i < SPIN_BATCH; ++i) cpuRelax();
+        notified = notifiedSince(ticket);
+    }
+
+    // only within the budget too: a yielding thread is never woken early by the notify, so
+    // yielding to a busy thread can cost a whole timeslice where parking would not
+    if (!notified && budget.count() > 0) {
+        phase = SpinTuning::Phase::Yield;
+        for (int i = 0; i < YIELD_ROUNDS && !notified && Clock::now() < yieldUntil; ++i) {
+            std::this_thread::yield();
+            notified = notifiedSince(ticket);
+        }
+    }
+
+    if (!notified && Clock::now() < deadline) {
+        phase = SpinTuning::Phase::Park;
+        std::unique_lock<std::mutex> lock(mutex);
+        // counted before the last check, so a notify either sees it or was already seen
+        parkedCount.fetch_add(1, std::memory_order_seq_cst);
+        auto woken = [this, ticket]() { return notifiedSince(ticket); };
+        if (deadline == Clock::time_point::max()) {
+            parkedCV.wait(lock, woken);
+            notified = true;
+        } else {
+            notified = parkedCV.wait_until(lock, deadline, woken);
+        }
+        parkedCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    tuning->record(phase, notified, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start));
+    return notified;
+}
+
+void AdaptiveWait::notifyOne() {
+    notify(false);
+}
+
+void AdaptiveWait::notifyAll() {
+    notify(true);
+}
+
+void AdaptiveWait::notify(bool all) {
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (parkedCount.load(std::memory_order_seq_cst) == 0) return; // spinners see the epoch
+
+    // a parked waiter checks the epoch under the mutex, so passing through it orders this
+    // notify after its check
+    { std::lock_guard<std::mutex> lock(mutex); }
+    if (all) parkedCV.notify_all();
+    else parkedCV.notify_one();
+}
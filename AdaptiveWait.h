@@ -0,0 +1,92 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+// How a wait ended, counted per SpinTuning (report-util)
+struct WaitStats {
+    unsigned long long spun = 0;     // notified while spinning
+    unsigned long long yielded = 0;  // notified while yielding
+    unsigned long long parked = 0;   // notified after parking on the condition variable
+    unsigned long long timedOut = 0; // deadline passed first
+    long long spinBudgetNs = 0;
+
+    unsigned long long total() const { return spun + yielded + parked + timedOut; }
+};
+
+/*
+    The spin budget of one kind of handoff, learned online. Every wait reports the gap
+    between starting to wait and being woken; the budget follows twice the recent gaps
+    (moving average over about 8 waits), so a handoff that usually lands within a few
+    microseconds is caught while spinning, and one that takes longer than MAX_SPIN_NS,
+    or a wait that times out, pulls the budget toward 0 so waiters park right away.
+    With one host CPU the budget stays 0: the thread that would notify needs that CPU.
+    Several AdaptiveWaits that see the same kind of handoff can share one.
+*/
+class SpinTuning {
+public:
+    enum class Phase { Spin, Yield, Park };
+
+    static constexpr long long INITIAL_SPIN_NS = 5000;
+    static constexpr long long MAX_SPIN_NS = 50000;
+
+    SpinTuning();
+
+    std::chrono::nanoseconds getBudget() const { return std::chrono::nanoseconds(budgetNs.load(std::memory_order_relaxed)); }
+    void record(Phase phase, bool notified, std::chrono::nanoseconds gap);
+    WaitStats getStats() const;
+
+private:
+    std::atomic<long long> budgetNs;
+    std::atomic<unsigned long long> spun{0}, yielded{0}, parked{0}, timedOut{0};
+};
+
+/*
+    Wakeup for a thread that waits on others: spins (with a pause instruction) for the
+    tuned budget, then yields a few times for at most another budget, then parks on a
+    condition variable. A handoff
+    that arrives while spinning costs no futex wake on either side; notify only touches
+    the mutex when somebody is parked.
+
+    Waiting takes a ticket first (prepareWait), then checks its condition, then waits
+    with the ticket: a notify between the two makes the wait return at once, so no
+    wakeup is lost without the waiter holding a lock across its check. Waits return
+    early on any notify, so callers loop and recheck.
+*/
+class AdaptiveWait {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Ticket = unsigned long long;
+
+    AdaptiveWait() : tuning(&ownTuning) {}
+    explicit AdaptiveWait(SpinTuning& shared) : tuning(&shared) {}
+    AdaptiveWait(const AdaptiveWait&) = delete;
+    AdaptiveWait& operator=(const AdaptiveWait&) = delete;
+
+    Ticket prepareWait() const { return epoch.load(std::memory_order_seq_cst); }
+
+    // true if notified since the ticket was taken, false if the deadline passed first
+    bool waitUntil(Ticket ticket, Clock::time_point deadline);
+    bool wait(Ticket ticket) { return waitUntil(ticket, Clock::time_point::max()); }
+    template <typename Rep, typename Period>
+    bool waitFor(Ticket ticket, std::chrono::duration<Rep, Period> timeout) {
+        return waitUntil(ticket, Clock::now() + timeout);
+    }
+
+    void notifyOne();
+    void notifyAll();
+
+    const SpinTuning& getTuning() const { return *tuning; }
+
+private:
+    std::atomic<Ticket> epoch{0};
+    std::atomic<int> parkedCount{0};
+    std::mutex mutex;
+    std::condition_variable parkedCV;
+    SpinTuning ownTuning;
+    SpinTuning* tuning;
+
+    bool notifiedSince(Ticket ticket) const { return epoch.load(std::memory_order_seq_cst) != ticket; }
+    void notify(bool all);
+};
@@ -0,0 +1,72 @@
+#include "AdmissionControl.h"
+
+#include <algorithm>
+
+AdmissionControl::AdmissionControl(size_t maxReady, size_t maxInFlight, AdmissionPolicy policy,
+                                   unsigned long long baseInterval)
+    : maxReady(maxReady), maxInFlight(maxInFlight), policy(policy),
+      baseInterval(std::max<unsigned long long>(1, baseInterval)), interval(this->baseInterval) {}
+
+bool AdmissionControl::over(size_t ready, size_t inFlight) const {
+    return (maxReady > 0 && ready >= maxReady) || (maxInFlight > 0 && inFlight >= maxInFlight);
+}
+
+AdmissionDecision AdmissionControl::admit(size_t ready, size_t inFlight) {
+    lastReady = ready;
+    lastInFlight = inFlight;
+    if (ready > peakReady.load()) peakReady = ready;
+    if (inFlight > peakInFlight.load()) peakInFlight = inFlight;
+
+    if (over(ready, inFlight)) {
+        switch (policy) {
+            case AdmissionPolicy::Block:
+                deferred++;
+                return AdmissionDecision::Wait;
+            case AdmissionPolicy::Drop:
+                rejected++;
+                return AdmissionDecision::Skip;
+            case AdmissionPolicy::Stretch:
+                deferred++;
+                interval = std::min(interval.load() * 2, baseInterval * MAX_STRETCH);
+                return AdmissionDecision::Skip;
+        }
+    }
+
+    // stretched intervals shrink only with clear headroom, so the rate does not flap at the limit
+    if (policy == AdmissionPolicy::Stretch && interval.load() > baseInterval &&
+        !over(ready * 2, inFlight * 2)) {
+        interval = std::max(interval.load() / 2, baseInterval);
+    }
+    admitted++;
+    return AdmissionDecision::Admit;
+}
+
+AdmissionStats AdmissionControl::getStats() const {
+    AdmissionStats stats;
+    stats.admitted = admitted.load();
+    stats.rejected = rejected.load();
+    stats.deferred = deferred.load();
+    stats.interval = interval.load();
+    stats.ready = lastReady.load();
+    stats.inFlight = lastInFlight.load();
+    stats.peakReady = peakReady.load();
+    stats.peakInFlight = peakInFlight.load();
+    return stats;
+}
+
+bool AdmissionControl::parsePolicy(const std::string& name, AdmissionPolicy& policy) {
+    if (name == "block") policy = AdmissionPolicy::Block;
+    else if (name == "drop") policy = AdmissionPolicy::Drop;
+    else if (name == "stretch") policy = AdmissionPolicy::Stretch;
+    else return false;
+    return true;
+}
+
+const char* AdmissionControl::policyName(AdmissionPolicy policy) {
+    switch (policy) {
+        case AdmissionPolicy::Block: return "block";
+        case AdmissionPolicy::Drop: return "drop";
+        case AdmissionPolicy::Stretch: return "stretch";
+    }
+    return "block";
+}
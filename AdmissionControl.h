@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <atomic>
+
+/*
+    Admission control for batch process generation (scheduler-start).
+
+    Before the generator adds a process it asks admit() with the current ready-queue
+    depth and the number of processes in flight (generated and not yet finished). Over
+    either limit (0 = no limit), the policy decides:
+        block    the generator waits and retries every millisecond, nothing is lost
+        drop     the process is never created and counted as rejected
+        stretch  the process is skipped and the generation interval doubles, up to
+                 MAX_STRETCH times batch-process-freq; it halves back down once the
+                 load is under half of both limits
+*/
+enum class AdmissionPolicy {
+    Block,
+    Drop,
+    Stretch
+};
+
+enum class AdmissionDecision {
+    Admit,
+    Wait, // block: ask again next millisecond
+    Skip  // drop / stretch: start a new interval
+};
+
+struct AdmissionStats {
+    unsigned long long admitted = 0;
+    unsigned long long rejected = 0;  // drop: processes never created
+    unsigned long long deferred = 0;  // block: milliseconds waited; stretch: intervals skipped
+    unsigned long long interval = 0;  // current generation interval in ms
+    size_t ready = 0;                 // as of the last admit()
+    size_t inFlight = 0;
+    size_t peakReady = 0;
+    size_t peakInFlight = 0;
+};
+
+class AdmissionControl {
+public:
+    static constexpr unsigned long long MAX_STRETCH = 1024;
+
+    AdmissionControl(size_t maxReady, size_t maxInFlight, AdmissionPolicy policy, unsigned long long baseInterval);
+
+    // Called by the generator thread only; the counters can be read from any thread
+    AdmissionDecision admit(size_t ready, size_t inFlight);
+    unsigned long long getInterval() const { return interval.load(); }
+
+    AdmissionStats getStats() const;
+    AdmissionPolicy getPolicy() const { return policy; }
+    size_t getMaxReady() const { return maxReady; }
+    size_t getMaxInFlight() const { return maxInFlight; }
+
+    static bool parsePolicy(const std::string& name, AdmissionPolicy& policy);
+    static const char* policyName(AdmissionPolicy policy);
+
+private:
+    const size_t maxReady;
+    const size_t maxInFlight;
+    const AdmissionPolicy policy;
+    const unsigned long long baseInterval;
+
+    std::atomic<unsigned long long> interval;
+    std::atomic<unsigned long long> admitted{0};
+    std::atomic<unsigned long long> rejected{0};
+    std::atomic<unsigned long long> deferred{0};
+    std::atomic<size_t> lastReady{0};
+    std::atomic<size_t> lastInFlight{0};
+    std::atomic<size_t> peakReady{0};
+    std::atomic<size_t> peakInFlight{0};
+
+    bool over(size_t ready, size_t inFlight) const;
+};
@@ -0,0 +1,103 @@
+#include "CFSScheduler.h"
+#include <algorithm>
+
+namespace {
+    // Linux's nice-to-weight table: each nice step is ~10% CPU, nice 0 = 1024
+    const unsigned long long NICE_0_WEIGHT = 1024;
+    const unsigned long long niceToWeight[40] = {
+        88761, 71755, 56483, 46273, 36291,
+        29154, 23254, 18705, 14949, 11916,
+         9548,  7620,  6100,  4904,  3906,
+         3121,  2501,  1991,  1586,  1277,
+         1024,   820,   655,   526,   423,
+          335,   272,   215,   172,   137,
+          110,    87,    70,    56,    45,
+           36,    29,    23,    18,    15,
+    };
+}
+
+CFSScheduler::CFSScheduler(int cores, int delay, unsigned long long targetLatency, unsigned long long minGranularity)
+    : RRScheduler(cores, delay, targetLatency),
+      targetLatency(targetLatency), minGranularity(std::max(1ULL, minGranularity)) {}
+
+unsigned long long CFSScheduler::weightOf(int nice) {
+    nice = std::clamp(nice, -20, 19);
+    return niceToWeight[nice + 20];
+}
+
+/*
+    New arrivals (and processes migrated from another domain) start at minVruntime so they neither starve the tree nor get
+    the CPU to themselves until they "catch up" with processes that ran for a while.
+    Sleepers get the same clamp on wakeup, less half a latency period of credit, so a process that slept
+    runs soon without being able to bank the whole sleep as CPU time.
+*/
+void CFSScheduler::enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) {
+    if (reason == RequeueReason::Arrival || reason == RequeueReason::Migrated) {
+        proc->setVruntime(std::max(proc->getVruntime(), minVruntime));
+    } else if (reason == RequeueReason::Woken) {
+        unsigned long long credit = targetLatency * 1024 / 2; // vruntime is in 1/1024ths of an instruction
+        unsigned long long floor = minVruntime > credit ? minVruntime - credit : 0;
+        proc->setVruntime(std::max(proc->getVruntime(), floor));
+    }
+
+    runQueue.insert({proc->getVruntime(), nextSeq++, proc});
+    queuedWeight += weightOf(proc->getNice());
+}
+
+// Leftmost entry: the process that has had the least weighted CPU time
+std::shared_ptr<Process> CFSScheduler::dequeueReady(int coreId) {
+    if (runQueue.empty()) return nullptr;
+
+    auto first = runQueue.begin();
+    auto proc = first->proc;
+    minVruntime = std::max(minVruntime, first->vruntime);
+    runQueue.erase(first);
+
+    unsigned long long weight = weightOf(proc->getNice());
+    queuedWeight -= weight;
+    runningWeight += weight;
+    return proc;
+}
+
+// Load balancing gives away the rightmost entry, the one that has had the most CPU
+std::shared_ptr<Process> CFSScheduler::stealReady() {
+    if (runQueue.empty()) return nullptr;
+
+    auto last = std::prev(runQueue.end());
+    auto proc = last->proc;
+    runQueue.erase(last);
+    queuedWeight -= weightOf(proc->getNice());
+    return proc;
+}
+
+size_t CFSScheduler::readyCount() const {
+    return runQueue.size();
+}
+
+std::vector<std::shared_ptr<Process>> CFSScheduler::readyList() const {
+    std::vector<std::shared_ptr<Process>> result;
+    for (const auto& entry : runQueue) result.push_back(entry.proc);
+    return result;
+}
+
+/*
+    slice = period * weight / totalWeight, with period = targetLatency * cores
+    (every runnable process should run once per targetLatency on some core).
+    Equal nice values reduce this to targetLatency / (runnable / cores).
+*/
+unsigned long long CFSScheduler::sliceLength(const std::shared_ptr<Process>& proc) const {
+    // proc was just dequeued, so its weight is already part of runningWeight
+    unsigned long long weight = weightOf(proc->getNice());
+    unsigned long long totalWeight = std::max(weight, queuedWeight + runningWeight);
+    unsigned long long period = targetLatency * coreCount;
+
+    unsigned long long slice = period * weight / totalWeight;
+    return std::clamp(slice, minGranularity, std::max(minGranularity, targetLatency));
+}
+
+// vruntime is kept in 1/1024ths of an instruction so heavy (negative nice) weights still advance
+void CFSScheduler::onSliceEnd(const std::shared_ptr<Process>& proc, unsigned long long executed) {
+    unsigned long long weight = weightOf(proc->getNice());
+    runningWeight -= weight;
+    proc->setVruntime(proc->getVruntime() + (executed * NICE_0_WEIGHT << 10) / weight);
+}
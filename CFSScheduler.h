@@ -0,0 +1,53 @@
+#pragma once
+#include "RRScheduler.h"
+#include <set>
+
+/*
+    Completely fair scheduler.
+    Runnable processes sit in a red-black tree (std::set) ordered by virtual runtime,
+    the number of instructions they have executed scaled by 1024 / weight(nice)
+    (kept in 1/1024ths of an instruction).
+    The leftmost (least vruntime) process always runs next.
+
+    Instead of a fixed quantum, each slice is the process's weighted share of
+    targetLatency, where the latency period covers all runnable processes spread
+    over the cores. Slices never go below minGranularity, so as load grows the
+    period stretches instead of the slices shrinking to nothing.
+*/
+class CFSScheduler : public RRScheduler {
+private:
+    struct TreeEntry {
+        unsigned long long vruntime;
+        unsigned long long seq;
+        std::shared_ptr<Process> proc;
+
+        bool operator<(const TreeEntry& other) const {
+            if (vruntime != other.vruntime) return vruntime < other.vruntime;
+            return seq < other.seq;
+        }
+    };
+
+    std::set<TreeEntry> runQueue;
+    unsigned long long nextSeq = 0;
+    unsigned long long minVruntime = 0;
+
+    unsigned long long targetLatency;
+    unsigned long long minGranularity;
+
+    unsigned long long queuedWeight = 0;  // guarded by queueMutex
+    unsigned long long runningWeight = 0; // scheduler thread only
+
+    static unsigned long long weightOf(int nice);
+
+protected:
+    void enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) override;
+    std::shared_ptr<Process> dequeueReady(int coreId) override;
+    size_t readyCount() const override;
+    std::vector<std::shared_ptr<Process>> readyList() const override;
+    std::shared_ptr<Process> stealReady() override;
+    unsigned long long sliceLength(const std::shared_ptr<Process>& proc) const override;
+    void onSliceEnd(const std::shared_ptr<Process>& proc, unsigned long long executed) override;
+
+public:
+    CFSScheduler(int cores, int delay, unsigned long long targetLatency, unsigned long long minGranularity);
+};
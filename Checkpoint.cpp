@@ -0,0 +1,289 @@
+#include "Checkpoint.h"
+
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+namespace {
+    constexpr char MAGIC[8] = "CSCKPT";
+    constexpr uint32_t VERSION = 7;
+
+    int64_t micros(std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    }
+
+    std::chrono::system_clock::time_point fromMicros(int64_t value) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(value)));
+    }
+
+    void writeConfig(CheckpointWriter& out, const Config& config) {
+        out.i32(config.numCPUs);
+        out.text(config.schedulerType);
+        out.u64(config.quantumCycles);
+        out.u64(config.batchProcessFreq);
+        out.u64(config.minInstructions);
+        out.u64(config.maxInstructions);
+        out.u64(config.delaysPerExec);
+        out.i32(config.maxCPUs);
+        out.i32(config.schedDomains);
+        out.u64(config.balanceInterval);
+        out.u64(config.balanceThreshold);
+        out.u64(config.rrAffinityWait);
+        out.i32(config.mlfqLevels);
+        out.u64(config.mlfqQuantumMultipliers.size());
+        for (auto multiplier : config.mlfqQuantumMultipliers) out.u64(multiplier);
+        out.u64(config.mlfqBoostInterval);
+        out.u64(config.cfsTargetLatency);
+        out.u64(config.cfsMinGranularity);
+        out.u8(config.processLogSink ? 1 : 0);
+        out.u64(config.logSinkBuffer);
+        out.u64(config.logSinkMaxOpenFiles);
+        out.u64(config.logSinkFlushInterval);
+        out.u64(config.traceBuffer);
+        out.u8(config.optimizePrograms ? 1 : 0);
+        out.u64(config.admissionMaxReady);
+        out.u64(config.admissionMaxInFlight);
+        out.text(config.admissionPolicy);
+        out.u64(config.reapRetention);
+        out.u8(config.reapSpillLogs ? 1 : 0);
+        out.text(config.cpuAffinity);
+    }
+
+    Config readConfig(CheckpointReader& in) {
+        Config config;
+        config.numCPUs = in.i32();
+        config.schedulerType = in.text();
+        config.quantumCycles = in.u64();
+        config.batchProcessFreq = in.u64();
+        config.minInstructions = in.u64();
+        config.maxInstructions = in.u64();
+        config.delaysPerExec = in.u64();
+        config.maxCPUs = in.i32();
+        config.schedDomains = in.i32();
+        config.balanceInterval = in.u64();
+        config.balanceThreshold = in.u64();
+        config.rrAffinityWait = in.u64();
+        config.mlfqLevels = in.i32();
+        config.mlfqQuantumMultipliers.resize(in.count(sizeof(uint64_t)));
+        for (auto& multiplier : config.mlfqQuantumMultipliers) multiplier = in.u64();
+        config.mlfqBoostInterval = in.u64();
+        config.cfsTargetLatency = in.u64();
+        config.cfsMinGranularity = in.u64();
+        config.processLogSink = in.u8() != 0;
+        config.logSinkBuffer = in.u64();
+        config.logSinkMaxOpenFiles = in.u64();
+        config.logSinkFlushInterval = in.u64();
+        config.traceBuffer = in.u64();
+        config.optimizePrograms = in.u8() != 0;
+        config.admissionMaxReady = in.u64();
+        config.admissionMaxInFlight = in.u64();
+        config.admissionPolicy = in.text();
+        config.reapRetention = in.u64();
+        config.reapSpillLogs = in.u8() != 0;
+        config.cpuAffinity = in.text();
+        return config;
+    }
+}
+
+void CheckpointWriter::text(std::string_view value) {
+    u32(static_cast<uint32_t>(value.size()));
+    raw(value.data(), value.size());
+}
+
+void CheckpointWriter::interned(const std::string& value) {
+    auto [it, inserted] = stringIds.try_emplace(value, static_cast<uint32_t>(strings.size()));
+    if (inserted) strings.push_back(value);
+    u32(it->second);
+}
+
+std::string CheckpointReader::text() {
+    uint32_t size = u32();
+    if (buffer.size() - offset < size) throw std::runtime_error("checkpoint is truncated");
+    std::string value(buffer.data() + offset, size);
+    offset += size;
+    return value;
+}
+
+const std::string& CheckpointReader::interned() {
+    uint32_t id = u32();
+    if (id >= strings.size()) throw std::runtime_error("checkpoint references an unknown string");
+    return strings[id];
+}
+
+void CheckpointReader::readStringTable() {
+    strings.resize(count(sizeof(uint32_t)));
+    for (auto& value : strings) value = text();
+}
+
+// Guards every resize against a corrupt count asking for more elements than the file holds
+uint64_t CheckpointReader::count(size_t minBytesEach) {
+    uint64_t n = u64();
+    if (n > (buffer.size() - offset) / std::max<size_t>(1, minBytesEach)) throw std::runtime_error("checkpoint is corrupt");
+    return n;
+}
+
+// Only the program is stored; executedTimestamp / executedCore / hasExecuted belong to executed copies
+void writeInstructions(CheckpointWriter& out, std::span<const Instruction> instructions) {
+    out.u64(instructions.size());
+    for (const auto& instr : instructions) {
+        out.u8(static_cast<uint8_t>(instr.type));
+        out.interned(instr.message);
+        out.interned(instr.var1);
+        out.interned(instr.var2);
+        out.interned(instr.var3);
+        out.u8((instr.var2IsImmediate ? 1 : 0) | (instr.var3IsImmediate ? 2 : 0));
+        out.u16(instr.var2ImmediateValue);
+        out.u16(instr.var3ImmediateValue);
+        out.u16(instr.value);
+        out.u8(instr.sleepTicks);
+        out.i32(instr.loopRepeat);
+        if (instr.type == InstructionType::FOR) writeInstructions(out, instr.loopInstructions);
+    }
+}
+
+std::vector<Instruction> readInstructions(CheckpointReader& in) {
+    std::vector<Instruction> instructions(in.count(30));
+    for (auto& instr : instructions) {
+        uint8_t type = in.u8();
+        if (type > static_cast<uint8_t>(InstructionType::FOR)) throw std::runtime_error("checkpoint has an unknown instruction");
+        instr.type = static_cast<InstructionType>(type);
+        instr.message = in.interned();
+        instr.var1 = in.interned();
+        instr.var2 = in.interned();
+        instr.var3 = in.interned();
+        uint8_t immediate = in.u8();
+        instr.var2IsImmediate = immediate & 1;
+        instr.var3IsImmediate = immediate & 2;
+        instr.var2ImmediateValue = in.u16();
+        instr.var3ImmediateValue = in.u16();
+        instr.value = in.u16();
+        instr.sleepTicks = in.u8();
+        instr.loopRepeat = in.i32();
+        if (instr.type == InstructionType::FOR) instr.loopInstructions = readInstructions(in);
+    }
+    return instructions;
+}
+
+std::string encodeCheckpoint(const Checkpoint& checkpoint) {
+    CheckpointWriter out;
+    writeConfig(out, checkpoint.config);
+    out.u64(checkpoint.processCounter);
+    out.i32(checkpoint.nextProcessNum);
+
+    std::unordered_map<const Process*, uint32_t> index;
+    out.u64(checkpoint.processes.size());
+    for (const auto& proc : checkpoint.processes) {
+        index[proc.get()] = static_cast<uint32_t>(index.size());
+        proc->writeCheckpoint(out);
+    }
+
+    // processes not in the list (should not happen) are left out rather than written dangling
+    std::vector<uint32_t> ready;
+    for (const auto& proc : checkpoint.readyOrder) {
+        auto it = index.find(proc.get());
+        if (it != index.end()) ready.push_back(it->second);
+    }
+    out.u64(ready.size());
+    for (auto id : ready) out.u32(id);
+
+    std::vector<std::pair<uint32_t, unsigned long long>> sleeping;
+    for (const auto& [proc, ticks] : checkpoint.sleeping) {
+        auto it = index.find(proc.get());
+        if (it != index.end()) sleeping.push_back({it->second, ticks});
+    }
+    out.u64(sleeping.size());
+    for (const auto& [id, ticks] : sleeping) {
+        out.u32(id);
+        out.u64(ticks);
+    }
+
+    out.u64(checkpoint.archived.size());
+    for (const auto& record : checkpoint.archived) {
+        out.interned(record.name);
+        out.i32(record.pid);
+        out.i64(micros(record.created));
+        out.i64(micros(record.finished));
+        out.u64(record.completedCommands);
+        out.u64(record.totalCommands);
+        out.i32(record.lastCore);
+        out.u64(record.migrations);
+    }
+
+    // string table goes first so the reader can resolve indices while parsing the body
+    CheckpointWriter head;
+    head.raw(MAGIC, sizeof(MAGIC));
+    head.u32(VERSION);
+    head.u64(out.getStrings().size());
+    for (const auto& value : out.getStrings()) head.text(value);
+    return head.getBody() + out.getBody();
+}
+
+bool saveCheckpoint(const std::string& path, const std::string& encoded, std::string& error) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        error = "cannot open " + path + " for writing";
+        return false;
+    }
+    file.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+    if (!file) {
+        error = "failed writing " + path;
+        return false;
+    }
+    return true;
+}
+
+bool loadCheckpoint(const std::string& path, Checkpoint& checkpoint, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    try {
+        CheckpointReader in(buffer);
+        char magic[sizeof(MAGIC)];
+        for (auto& c : magic) c = static_cast<char>(in.u8());
+        if (!std::equal(std::begin(magic), std::end(magic), MAGIC)) throw std::runtime_error("not a checkpoint file");
+        if (in.u32() != VERSION) throw std::runtime_error("unsupported checkpoint version");
+        in.readStringTable();
+
+        checkpoint.config = readConfig(in);
+        checkpoint.processCounter = in.u64();
+        checkpoint.nextProcessNum = in.i32();
+
+        checkpoint.processes.resize(in.count(64));
+        for (auto& proc : checkpoint.processes) proc = Process::readCheckpoint(in);
+
+        auto at = [&](uint32_t id) {
+            if (id >= checkpoint.processes.size()) throw std::runtime_error("checkpoint references an unknown process");
+            return checkpoint.processes[id];
+        };
+
+        checkpoint.readyOrder.resize(in.count(sizeof(uint32_t)));
+        for (auto& proc : checkpoint.readyOrder) proc = at(in.u32());
+
+        checkpoint.sleeping.resize(in.count(sizeof(uint32_t) + sizeof(uint64_t)));
+        for (auto& [proc, ticks] : checkpoint.sleeping) {
+            proc = at(in.u32());
+            ticks = in.u64();
+        }
+
+        checkpoint.archived.resize(in.count(52));
+        for (auto& record : checkpoint.archived) {
+            record.name = in.interned();
+            record.pid = in.i32();
+            record.created = fromMicros(in.i64());
+            record.finished = fromMicros(in.i64());
+            record.completedCommands = in.u64();
+            record.totalCommands = in.u64();
+            record.lastCore = in.i32();
+            record.migrations = in.u64();
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    return true;
+}
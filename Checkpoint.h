@@ -0,0 +1,108 @@
+#pragma once
+#include "Config.h"
+#include "Process.h"
+#include "ProcessArchive.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <span>
+#include <string_view>
+
+/*
+    Binary checkpoint of the whole emulator (`checkpoint <file>` / `restore <file>`).
+
+    Layout, little endian:
+        header      "CSCKPT" magic, format version
+        strings     table of every interned string (variable names, messages)
+        config      every Config field
+        counters    batch name counter, next PID
+        processes   program, instruction pointer, loop frames (counters only, the body is
+                    the FOR the enclosing frame stepped over), variables, counters,
+                    state, scheduling fields and log lines of each process
+        ready       indices of the queued processes in dispatch order
+        sleeping    indices of the SLEEPing processes with the ticks they have left
+        archived    records of the reaped processes
+
+    Variable names repeat across every process and instruction, so they are stored once
+    in the string table and referenced by index. The whole file is built in memory and
+    written (or read) with one call, then parsed from the buffer.
+*/
+class CheckpointWriter {
+public:
+    void u8(uint8_t value) { raw(&value, sizeof(value)); }
+    void u16(uint16_t value) { raw(&value, sizeof(value)); }
+    void u32(uint32_t value) { raw(&value, sizeof(value)); }
+    void u64(uint64_t value) { raw(&value, sizeof(value)); }
+    void i32(int32_t value) { raw(&value, sizeof(value)); }
+    void i64(int64_t value) { raw(&value, sizeof(value)); }
+    void text(std::string_view value);     // length-prefixed, for one-off strings
+    void interned(const std::string& value); // index into the string table
+
+    void raw(const void* data, size_t size) { body.append(static_cast<const char*>(data), size); }
+
+    const std::string& getBody() const { return body; }
+    const std::vector<std::string>& getStrings() const { return strings; }
+
+private:
+    std::string body;
+    std::vector<std::string> strings;
+    std::unordered_map<std::string, uint32_t> stringIds;
+};
+
+// Reads what CheckpointWriter wrote; throws std::runtime_error on a truncated or corrupt file
+class CheckpointReader {
+public:
+    CheckpointReader(const std::string& buffer) : buffer(buffer) {}
+
+    uint8_t u8() { return get<uint8_t>(); }
+    uint16_t u16() { return get<uint16_t>(); }
+    uint32_t u32() { return get<uint32_t>(); }
+    uint64_t u64() { return get<uint64_t>(); }
+    int32_t i32() { return get<int32_t>(); }
+    int64_t i64() { return get<int64_t>(); }
+    std::string text();
+    const std::string& interned();
+
+    void readStringTable();
+    uint64_t count(size_t minBytesEach = 1); // element count, checked against the bytes left
+
+private:
+    const std::string& buffer;
+    size_t offset = 0;
+    std::vector<std::string> strings;
+
+    template <typename T>
+    T get() {
+        if (buffer.size() - offset < sizeof(T)) throw std::runtime_error("checkpoint is truncated");
+        T value;
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+};
+
+// Programs (with FOR bodies, recursively); used by Process::writeCheckpoint / readCheckpoint
+void writeInstructions(CheckpointWriter& out, std::span<const Instruction> instructions);
+std::vector<Instruction> readInstructions(CheckpointReader& in);
+
+struct Checkpoint {
+    Config config;
+    unsigned long long processCounter = 1; // next batch process name number
+    int nextProcessNum = 1;
+    std::vector<std::shared_ptr<Process>> processes;
+    std::vector<std::shared_ptr<Process>> readyOrder;
+    std::vector<std::pair<std::shared_ptr<Process>, unsigned long long>> sleeping;
+    std::vector<ProcessRecord> archived;
+};
+
+// The file contents, built in memory so the capture can hold its locks without file I/O
+std::string encodeCheckpoint(const Checkpoint& checkpoint);
+
+// Both return false and fill error instead of throwing
+bool saveCheckpoint(const std::string& path, const std::string& encoded, std::string& error);
+bool loadCheckpoint(const std::string& path, Checkpoint& checkpoint, std::string& error);
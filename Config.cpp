@@ -30,6 +30,34 @@ Config loadConfig(const std::string& filePath) {  // ✅ No default here
         else if (key == "min-ins") config.minInstructions = std::stoull(value);
         else if (key == "max-ins") config.maxInstructions = std::stoull(value);
         else if (key == "delays-per-exec") config.delaysPerExec = std::stoull(value);
+        else if (key == "max-cpu") config.maxCPUs = std::stoi(value);
+        else if (key == "sched-domains") config.schedDomains = std::stoi(value);
+        else if (key == "balance-interval") config.balanceInterval = std::stoull(value);
+        else if (key == "balance-threshold") config.balanceThreshold = std::stoull(value);
+        else if (key == "rr-affinity-wait") config.rrAffinityWait = std::stoull(value);
+        else if (key == "mlfq-levels") config.mlfqLevels = std::stoi(value);
+        else if (key == "mlfq-quantum-multipliers") {
+            // space separated list, e.g. "1 2 4"
+            config.mlfqQuantumMultipliers.clear();
+            std::istringstream list(value);
+            unsigned long long multiplier;
+            while (list >> multiplier) config.mlfqQuantumMultipliers.push_back(multiplier);
+        }
+        else if (key == "mlfq-boost-interval") config.mlfqBoostInterval = std::stoull(value);
+        else if (key == "cfs-target-latency") config.cfsTargetLatency = std::stoull(value);
+        else if (key == "cfs-min-granularity") config.cfsMinGranularity = std::stoull(value);
+        else if (key == "process-log-sink") config.processLogSink = std::stoi(value) != 0;
+        else if (key == "log-sink-buffer") config.logSinkBuffer = std::stoull(value);
+        else if (key == "log-sink-max-open-files") config.logSinkMaxOpenFiles = std::stoull(value);
+        else if (key == "log-sink-flush-interval") config.logSinkFlushInterval = std::stoull(value);
+        else if (key == "trace-buffer") config.traceBuffer = std::stoull(value);
+        else if (key == "optimize-programs") config.optimizePrograms = std::stoi(value) != 0;
+        else if (key == "admission-max-ready") config.admissionMaxReady = std::stoull(value);
+        else if (key == "admission-max-inflight") config.admissionMaxInFlight = std::stoull(value);
+        else if (key == "admission-policy") config.admissionPolicy = value;
+        else if (key == "reap-retention") config.reapRetention = std::stoull(value);
+        else if (key == "reap-spill-logs") config.reapSpillLogs = std::stoi(value) != 0;
+        else if (key == "cpu-affinity") config.cpuAffinity = value;
     }
 
     return config;
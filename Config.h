@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 
 struct Config {
     int numCPUs;
@@ -9,6 +10,60 @@ struct Config {
     unsigned long long minInstructions;
     unsigned long long maxInstructions;
     unsigned long long delaysPerExec;
+
+    // Most cores `cores add` can grow the machine to (never below num-cpu)
+    int maxCPUs = 256;
+
+    // Scheduling domains: cores are split into schedDomains groups, each with its own
+    // scheduler; every balanceInterval ms queued processes move from the longest to the
+    // shortest domain queue if they differ by more than balanceThreshold (1 = one flat domain)
+    int schedDomains = 1;
+    unsigned long long balanceInterval = 10;
+    unsigned long long balanceThreshold = 4;
+
+    // RR: ticks a requeued process waits for its last core before any idle core
+    // may take it (0 = no affinity, plain FIFO)
+    unsigned long long rrAffinityWait = 0;
+
+    // MLFQ: number of queues, quantum multiplier per level (times quantum-cycles)
+    // and how many ticks between priority boosts back to the top queue
+    int mlfqLevels = 3;
+    std::vector<unsigned long long> mlfqQuantumMultipliers = {1, 2, 4};
+    unsigned long long mlfqBoostInterval = 1000;
+
+    // CFS: every runnable process should get a slice within targetLatency
+    // instructions per core, but no slice is shorter than minGranularity
+    unsigned long long cfsTargetLatency = 48;
+    unsigned long long cfsMinGranularity = 4;
+
+    // Process log sink: when on, every PRINT is also written to processLogs/<name>.txt
+    // by a background thread. Each core buffers up to logSinkBuffer records, the writer
+    // drains every logSinkFlushInterval ms and keeps at most logSinkMaxOpenFiles open
+    bool processLogSink = false;
+    unsigned long long logSinkBuffer = 4096;
+    unsigned long long logSinkMaxOpenFiles = 64;
+    unsigned long long logSinkFlushInterval = 100;
+
+    // Scheduler event trace (trace start/stop): events each core can hold per trace
+    unsigned long long traceBuffer = 8192;
+
+    // Run constant propagation and dead-store elimination over every generated program
+    bool optimizePrograms = false;
+
+    // Batch generation admission control: most queued / unfinished processes before
+    // admissionPolicy ("block", "drop" or "stretch") applies (0 = no limit)
+    unsigned long long admissionMaxReady = 0;
+    unsigned long long admissionMaxInFlight = 0;
+    std::string admissionPolicy = "block";
+
+    // Finished processes are replaced by a compact record reapRetention ms after they
+    // finish (0 = keep them); reapSpillLogs writes their log lines to processArchive/ first
+    unsigned long long reapRetention = 0;
+    bool reapSpillLogs = false;
+
+    // Host CPU pinning of core executor, scheduler and generator threads: "none",
+    // "compact", "scatter" or a CPU list such as "0-3 8" (see CpuAffinity)
+    std::string cpuAffinity = "none";
 };
 
 Config loadConfig(const std::string& filePath = "config.txt");
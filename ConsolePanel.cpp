@@ -65,9 +65,11 @@ void ConsolePanel::setCurrentScreen(std::shared_ptr<Console> screenPanel){
 
    To avoid duplication, it uses a set of currently running processes ('runningProcesses')
    and excludes them from the "Finished" list even if marked finished, ensuring accurate display.
+   Reaped processes (the archive) are listed first, from their records.
  */
 void ConsolePanel::listProcesses(const std::vector<std::shared_ptr<Process>>& allProcesses,
-                                 const std::vector<std::shared_ptr<Process>>& runningProcesses) {
+                                 const std::vector<std::shared_ptr<Process>>& runningProcesses,
+                                 const ProcessArchive& archive) {
     std::unordered_set<std::shared_ptr<Process>> runningSet(runningProcesses.begin(), runningProcesses.end());
 
     std::cout << "Running Processes:\n";
@@ -85,6 +87,14 @@ void ConsolePanel::listProcesses(const std::vector<std::shared_ptr<Process>>& al
     }
 
     std::cout << "\nFinished Processes:\n";
+    archive.forEach([](const ProcessRecord& record) {
+        std::cout << std::left << std::setw(15) << record.name
+                  << Process::formatTime(record.created)        << "   "
+                  << "Finished!"                                << RESET << "   "
+                  << ORANGE     << record.completedCommands     << RESET << BLUE << " / " << RESET
+                  << ORANGE     << record.totalCommands         << RESET
+                  << "\n";
+    });
     for (const auto& proc : allProcesses) {
         if (proc->getProcessName() == "MAIN_SCREEN") continue;
 
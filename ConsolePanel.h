@@ -2,6 +2,7 @@
 #include "Console.h"
 #include "Process.h"
 #include "RRScheduler.h"
+#include "ProcessArchive.h"
 
 #include <string>
 #include <vector>
@@ -25,7 +26,8 @@ class ConsolePanel{
         
         void addConsolePanel(std::shared_ptr<Console> screenPanel);
         static void listProcesses(const std::vector<std::shared_ptr<Process>>& allProcesses,
-                                 const std::vector<std::shared_ptr<Process>>& runningProcesses);
+                                 const std::vector<std::shared_ptr<Process>>& runningProcesses,
+                                 const ProcessArchive& archive);
 
 
 };
\ No newline at end of file
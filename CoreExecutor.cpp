@@ -0,0 +1,165 @@
+#include "CoreExecutor.h"
+#include "CpuAffinity.h"
+
+#include <algorithm>
+#include <utility>
+
+CoreTask::CoreTask(CoreTask&& other) noexcept
+    : handle(std::exchange(other.handle, nullptr)), state(std::move(other.state)) {}
+
+CoreTask& CoreTask::operator=(CoreTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) handle.destroy(); // never spawned
+        handle = std::exchange(other.handle, nullptr);
+        state = std::move(other.state);
+    }
+    return *this;
+}
+
+// A task that was spawned but never joined keeps running on its own, like a detached thread
+CoreTask::~CoreTask() {
+    if (handle) handle.destroy();
+}
+
+void CoreTask::join() {
+    if (!state) return;
+    while (!state->done.load(std::memory_order_acquire)) {
+        auto ticket = state->finished.prepareWait();
+        if (state->done.load(std::memory_order_acquire)) break;
+        state->finished.wait(ticket);
+    }
+    state.reset();
+}
+
+SpinTuning& CoreTask::joinTuning() {
+    static SpinTuning tuning;
+    return tuning;
+}
+
+void CoreEvent::set() {
+    std::coroutine_handle<> resumed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!waiter) {
+            signaled = true;
+            return;
+        }
+        resumed = std::exchange(waiter, nullptr);
+    }
+    CoreExecutor::shared().schedule(resumed);
+}
+
+// Returning false resumes the caller right away: the event was set before it got here
+bool CoreEvent::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(event.mutex);
+    if (event.signaled) {
+        event.signaled = false;
+        return false;
+    }
+    event.waiter = handle;
+    return true;
+}
+
+CoreExecutor::CoreExecutor(unsigned threads) {
+    threads = std::max(1u, threads);
+    workers.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        workers.emplace_back(&CoreExecutor::workerLoop, this, i);
+    }
+}
+
+// Tasks still suspended at shutdown (the process is exiting) are abandoned, not resumed
+CoreExecutor::~CoreExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notifyAll();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+CoreExecutor& CoreExecutor::shared() {
+    static CoreExecutor executor(std::thread::hardware_concurrency());
+    return executor;
+}
+
+void CoreExecutor::setWorkerCpus(const std::vector<int>& cpus) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        workerCpus = cpus;
+        ++pinGeneration;
+    }
+    workAvailable.notifyAll();
+}
+
+void CoreExecutor::spawn(CoreTask& task) {
+    if (task.handle) schedule(std::exchange(task.handle, nullptr));
+}
+
+void CoreExecutor::schedule(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        runQueue.push_back(handle);
+    }
+    workAvailable.notifyOne();
+}
+
+void CoreExecutor::scheduleAt(std::coroutine_handle<> handle, Clock::time_point when) {
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        earliest = timers.empty() || when < timers.top().when;
+        timers.push({when, nextTimerSeq++, handle});
+    }
+    // idle workers are waiting for the old earliest deadline; one has to wait for this one instead
+    if (earliest) workAvailable.notifyOne();
+}
+
+/*
+    Runs queued tasks in FIFO order. Between tasks, every timer that is due moves to the
+    back of the run queue; with nothing to run, a worker waits (AdaptiveWait) until the
+    earliest deadline or until something is scheduled. After setWorkerCpus, every
+    worker pins itself the next time it wakes up.
+*/
+void CoreExecutor::workerLoop(unsigned index) {
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned long long pinnedGeneration = 0;
+    while (true) {
+        if (pinnedGeneration != pinGeneration) {
+            pinnedGeneration = pinGeneration;
+            int cpu = index < workerCpus.size() ? workerCpus[index] : -1;
+            lock.unlock();
+            CpuAffinity::pinCurrentThread(cpu);
+            lock.lock();
+            continue;
+        }
+
+        auto now = Clock::now();
+        while (!timers.empty() && timers.top().when <= now) {
+            runQueue.push_back(timers.top().handle);
+            timers.pop();
+        }
+
+        if (!runQueue.empty()) {
+            auto handle = runQueue.front();
+            runQueue.pop_front();
+            if (!runQueue.empty()) workAvailable.notifyOne(); // more than this worker can take
+            lock.unlock();
+            resumes.fetch_add(1, std::memory_order_relaxed);
+            handle.resume();
+            lock.lock();
+            continue;
+        }
+
+        if (stopping) return;
+
+        // the ticket is taken under the lock, so anything queued after this check wakes us
+        auto ticket = workAvailable.prepareWait();
+        auto deadline = timers.empty() ? Clock::time_point::max() : timers.top().when;
+        lock.unlock();
+        workAvailable.waitUntil(ticket, deadline);
+        lock.lock();
+    }
+}
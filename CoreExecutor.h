@@ -0,0 +1,177 @@
+#pragma once
+#include <coroutine>
+#include <chrono>
+#include <deque>
+#include <queue>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "AdaptiveWait.h"
+
+class CoreExecutor;
+
+/*
+    One emulated core's work (an FCFS core worker, an RR slice, an RR core clock), as a
+    C++20 coroutine run by CoreExecutor. It starts suspended; CoreExecutor::spawn
+    queues it. Owners keep the CoreTask the way they used to keep the std::thread:
+    joinable() until it has been joined, join() blocks the calling host thread until the
+    coroutine has returned. Never join from inside another CoreTask.
+*/
+class CoreTask {
+    struct State {
+        std::atomic<bool> done{false};
+        AdaptiveWait finished{joinTuning()};
+    };
+
+public:
+    struct promise_type {
+        std::shared_ptr<State> state = std::make_shared<State>();
+
+        CoreTask get_return_object() {
+            return CoreTask(std::coroutine_handle<promise_type>::from_promise(*this), state);
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // the frame is freed before joiners are released, so nothing of it outlives join()
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                auto state = std::move(handle.promise().state);
+                handle.destroy();
+                state->done.store(true, std::memory_order_release);
+                state->finished.notifyAll();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    CoreTask() = default;
+    CoreTask(CoreTask&& other) noexcept;
+    CoreTask& operator=(CoreTask&& other) noexcept;
+    CoreTask(const CoreTask&) = delete;
+    CoreTask& operator=(const CoreTask&) = delete;
+    ~CoreTask();
+
+    bool joinable() const { return state != nullptr; }
+    void join();
+
+    // Shared by every join: RR joins each slice right after it ended, a short handoff
+    static SpinTuning& joinTuning();
+
+private:
+    friend class CoreExecutor;
+
+    CoreTask(std::coroutine_handle<> handle, std::shared_ptr<State> state)
+        : handle(handle), state(std::move(state)) {}
+
+    std::coroutine_handle<> handle; // only until spawned; the executor owns it after that
+    std::shared_ptr<State> state;
+};
+
+/*
+    Auto-reset event a single CoreTask waits on (co_await event). set() resumes the
+    waiter on the executor, or, if nobody is waiting yet, lets the next wait through, so a
+    wakeup between checking a condition and waiting is never lost.
+*/
+class CoreEvent {
+public:
+    void set();
+
+    struct Awaiter {
+        CoreEvent& event;
+        bool await_ready() { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        void await_resume() {}
+    };
+    Awaiter operator co_await() { return {*this}; }
+
+private:
+    std::mutex mutex;
+    bool signaled = false;
+    std::coroutine_handle<> waiter;
+};
+
+/*
+    M:N core virtualization. Every emulated core of every scheduler runs as a CoreTask on
+    one fixed pool of hardware_concurrency() host threads instead of a thread of its own,
+    so 128 cores no longer means 256+ host threads taking turns on far fewer CPUs.
+
+    A CoreTask gives its host thread up at every boundary where the old thread blocked
+    or could be preempted: co_await delay(ms) for delays-per-exec and core clocks (a
+    timer queue resumes it once the time has passed), co_await yield() between bursts,
+    and co_await on a CoreEvent while a core has nothing assigned. Code running inside a
+    CoreTask must never block its host thread for long (no sleep_for, no waiting on
+    condition variables), since that host thread is shared by every other core.
+
+    Idle workers wait on an AdaptiveWait, so a core handed work right after its host
+    thread went idle is picked up by a spinning worker instead of through a futex wake.
+*/
+class CoreExecutor {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit CoreExecutor(unsigned threads);
+    ~CoreExecutor();
+
+    // The pool every scheduler uses, created on first use
+    static CoreExecutor& shared();
+
+    void spawn(CoreTask& task); // starts a task returned by a CoreTask coroutine
+    void schedule(std::coroutine_handle<> handle);
+    void scheduleAt(std::coroutine_handle<> handle, Clock::time_point when);
+
+    struct DelayAwaiter {
+        CoreExecutor& executor;
+        std::chrono::milliseconds duration;
+        bool await_ready() { return duration.count() <= 0; }
+        void await_suspend(std::coroutine_handle<> handle) { executor.scheduleAt(handle, Clock::now() + duration); }
+        void await_resume() {}
+    };
+    struct YieldAwaiter {
+        CoreExecutor& executor;
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { executor.schedule(handle); }
+        void await_resume() {}
+    };
+    DelayAwaiter delay(std::chrono::milliseconds duration) { return {*this, duration}; }
+    YieldAwaiter yield() { return {*this}; }
+
+    // Host CPU per pool thread (cpu-affinity), -1 = unpinned; each thread re-pins itself
+    void setWorkerCpus(const std::vector<int>& cpus);
+
+    WaitStats getWaitStats() const { return workAvailable.getTuning().getStats(); }
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+    unsigned long long getResumeCount() const { return resumes.load(std::memory_order_relaxed); }
+
+private:
+    struct Timer {
+        Clock::time_point when;
+        unsigned long long seq; // FIFO among equal deadlines
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer& other) const {
+            if (when != other.when) return when > other.when;
+            return seq > other.seq;
+        }
+    };
+
+    std::mutex mutex;
+    AdaptiveWait workAvailable; // idle workers spin, yield, then park on it
+    std::deque<std::coroutine_handle<>> runQueue;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    unsigned long long nextTimerSeq = 0;
+    bool stopping = false;
+    std::atomic<unsigned long long> resumes{0};
+    std::vector<int> workerCpus;
+    unsigned long long pinGeneration = 0; // bumped by setWorkerCpus
+    std::vector<std::thread> workers;
+
+    void workerLoop(unsigned index);
+};
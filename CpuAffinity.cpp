@@ -0,0 +1,121 @@
+#include "CpuAffinity.h"
+
+#include <thread>
+#include <sstream>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+unsigned CpuAffinity::hostCpuCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool CpuAffinity::parse(const std::string& spec, CpuAffinity& affinity, std::string& error) {
+    affinity = CpuAffinity();
+    if (spec.empty() || spec == "none") return true;
+    if (spec == "compact") {
+        affinity.mode = Mode::Compact;
+        return true;
+    }
+    if (spec == "scatter") {
+        affinity.mode = Mode::Scatter;
+        return true;
+    }
+
+    // explicit list: CPUs and ranges separated by spaces or commas
+    std::string text = spec;
+    std::replace(text.begin(), text.end(), ',', ' ');
+    std::istringstream in(text);
+    std::string item;
+    int hostCpus = static_cast<int>(hostCpuCount());
+    while (in >> item) {
+        int first, last;
+        try {
+            size_t dash = item.find('-');
+            first = std::stoi(item.substr(0, dash));
+            last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+        } catch (const std::exception&) {
+            error = "'" + item + "' is not a CPU or range";
+            return false;
+        }
+        if (first < 0 || last < first) {
+            error = "'" + item + "' is not a CPU or range";
+            return false;
+        }
+        if (last >= hostCpus) {
+            error = "CPU " + std::to_string(last) + " does not exist (host has " + std::to_string(hostCpus) + ")";
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) affinity.cpus.push_back(cpu);
+    }
+    if (affinity.cpus.empty()) {
+        error = "empty CPU list";
+        return false;
+    }
+    affinity.mode = Mode::List;
+    return true;
+}
+
+int CpuAffinity::cpuFor(size_t index, size_t count) const {
+    size_t hostCpus = hostCpuCount();
+    switch (mode) {
+        case Mode::None:
+            return -1;
+        case Mode::Compact:
+            return static_cast<int>(index % hostCpus);
+        case Mode::Scatter:
+            if (count <= hostCpus) return static_cast<int>(index * hostCpus / count);
+            return static_cast<int>(index % hostCpus);
+        case Mode::List:
+            return cpus[index % cpus.size()];
+    }
+    return -1;
+}
+
+std::vector<int> CpuAffinity::plan(size_t count) const {
+    std::vector<int> result(count);
+    for (size_t i = 0; i < count; ++i) result[i] = cpuFor(i, count);
+    return result;
+}
+
+std::string CpuAffinity::describe() const {
+    switch (mode) {
+        case Mode::None: return "none";
+        case Mode::Compact: return "compact";
+        case Mode::Scatter: return "scatter";
+        case Mode::List: break;
+    }
+    std::string text;
+    for (int cpu : cpus) text += (text.empty() ? "" : " ") + std::to_string(cpu);
+    return text;
+}
+
+bool CpuAffinity::pinCurrentThread(int cpu) {
+    unsigned hostCpus = hostCpuCount();
+#ifdef _WIN32
+    // one processor group (up to 64 CPUs), like the rest of the Windows console build
+    DWORD_PTR mask = 0;
+    if (cpu >= 0) {
+        mask = DWORD_PTR(1) << (cpu % 64);
+    } else {
+        DWORD_PTR process = 0, system = 0;
+        if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system)) return false;
+        mask = process;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu >= 0) {
+        CPU_SET(cpu, &set);
+    } else {
+        for (unsigned i = 0; i < hostCpus; ++i) CPU_SET(i, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#endif
+}
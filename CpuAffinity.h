@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/*
+    Host CPU pinning (cpu-affinity). The pinned host threads are numbered in one
+    sequence: the core executor's threads first (they run every emulated core), then the
+    scheduler threads, then the batch generator. Thread k of n gets:
+        none       no pinning, every host CPU allowed
+        compact    CPU k: neighbouring threads share neighbouring CPUs and their caches
+        scatter    CPU k * H / n: spread evenly over all H host CPUs
+        <list>     the k-th entry of an explicit list, e.g. "0-3 8 10" (reused round robin)
+    Pinning is always done by the thread itself (pinCurrentThread), so it works the same
+    for std::threads and the executor's pool.
+*/
+class CpuAffinity {
+public:
+    enum class Mode { None, Compact, Scatter, List };
+
+    // false with error set for an unknown mode, a malformed list or a CPU the host lacks
+    static bool parse(const std::string& spec, CpuAffinity& affinity, std::string& error);
+
+    // Host CPU of thread index out of count pinned threads, -1 = not pinned
+    int cpuFor(size_t index, size_t count) const;
+    std::vector<int> plan(size_t count) const;
+
+    Mode getMode() const { return mode; }
+    std::string describe() const;
+
+    static unsigned hostCpuCount();
+    // -1 allows every host CPU again; false if the OS refused
+    static bool pinCurrentThread(int cpu);
+
+private:
+    Mode mode = Mode::None;
+    std::vector<int> cpus; // Mode::List
+};
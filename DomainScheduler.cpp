@@ -0,0 +1,195 @@
+#include "DomainScheduler.h"
+#include "CpuAffinity.h"
+#include <chrono>
+
+namespace {
+    int totalCores(const std::vector<std::unique_ptr<Scheduler>>& domains) {
+        int total = 0;
+        for (const auto& domain : domains) total += domain->getCoreCount();
+        return total;
+    }
+}
+
+DomainScheduler::DomainScheduler(std::vector<std::unique_ptr<Scheduler>> doms, unsigned long long delay,
+                                 unsigned long long interval, size_t threshold)
+    : Scheduler(totalCores(doms), delay), domains(std::move(doms)),
+      balanceInterval(interval), balanceThreshold(threshold) {
+    // give each domain its own range of global core ids
+    int offset = 0;
+    for (auto& domain : domains) {
+        domain->setCoreOffset(offset);
+        offset += domain->getCoreCount();
+    }
+}
+
+DomainScheduler::~DomainScheduler() {
+    stop();
+}
+
+void DomainScheduler::start() {
+    running = true;
+
+    for (auto& domain : domains) domain->start();
+
+    schedulerThread = std::thread([this]() {
+        CpuAffinity::pinCurrentThread(schedulerCpu);
+        schedulerLoop();
+    });
+}
+
+void DomainScheduler::setSchedulerCpus(const std::vector<int>& cpus) {
+    for (size_t i = 0; i < domains.size(); ++i) {
+        domains[i]->setSchedulerCpus({i < cpus.size() ? cpus[i] : -1});
+    }
+    schedulerCpu = cpus.size() > domains.size() ? cpus[domains.size()] : -1;
+}
+
+void DomainScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(balanceMutex);
+        running = false;
+    }
+    balanceCV.notify_all();
+    if (schedulerThread.joinable()) schedulerThread.join();
+
+    for (auto& domain : domains) domain->stop();
+}
+
+void DomainScheduler::schedulerLoop() {
+    while (running) {
+        {
+            std::unique_lock<std::mutex> lock(balanceMutex);
+            balanceCV.wait_for(lock, std::chrono::milliseconds(balanceInterval), [this]() {
+                return !running;
+            });
+        }
+        if (!running) break;
+
+        balance();
+    }
+}
+
+CoreTask DomainScheduler::coreWorker(int coreId) {
+    // cores belong to the domain schedulers
+    co_return;
+}
+
+void DomainScheduler::balance() {
+    if (domains.size() < 2) return;
+
+    // At most one move batch per domain per pass so a burst of arrivals cannot keep it spinning
+    for (size_t pass = 0; pass < domains.size(); ++pass) {
+        size_t busiest = 0, idlest = 0;
+        size_t maxLen = 0, minLen = SIZE_MAX;
+
+        for (size_t d = 0; d < domains.size(); ++d) {
+            size_t len = domains[d]->getReadyQueueSize();
+            if (len > maxLen) { maxLen = len; busiest = d; }
+            if (len < minLen) { minLen = len; idlest = d; }
+        }
+
+        if (maxLen - minLen <= balanceThreshold) return;
+
+        size_t toMove = (maxLen - minLen) / 2;
+        for (size_t i = 0; i < toMove; ++i) {
+            auto proc = domains[busiest]->stealReadyProcess();
+            if (!proc) break;
+            domains[idlest]->adoptProcess(proc);
+            balancedMoves++;
+        }
+    }
+}
+
+void DomainScheduler::addProcess(const std::shared_ptr<Process>& proc) {
+    domains[nextDomain++ % domains.size()]->addProcess(proc);
+}
+
+void DomainScheduler::adoptProcess(const std::shared_ptr<Process>& proc) {
+    domains[nextDomain++ % domains.size()]->adoptProcess(proc);
+}
+
+int DomainScheduler::getBusyCoreCount() const {
+    int count = 0;
+    for (const auto& domain : domains) count += domain->getBusyCoreCount();
+    return count;
+}
+
+size_t DomainScheduler::getReadyQueueSize() const {
+    size_t count = 0;
+    for (const auto& domain : domains) count += domain->getReadyQueueSize();
+    return count;
+}
+
+size_t DomainScheduler::getWaitingCount() const {
+    size_t count = 0;
+    for (const auto& domain : domains) count += domain->getWaitingCount();
+    return count;
+}
+
+// Domains own consecutive core ranges, so concatenating keeps global core order
+std::vector<CoreUtilization> DomainScheduler::getCoreUtilization(unsigned windowSeconds) const {
+    std::vector<CoreUtilization> result;
+    for (const auto& domain : domains) {
+        auto cores = domain->getCoreUtilization(windowSeconds);
+        result.insert(result.end(), cores.begin(), cores.end());
+    }
+    return result;
+}
+
+void DomainScheduler::setTraced(bool enabled) {
+    traced = enabled;
+    for (auto& domain : domains) domain->setTraced(enabled);
+}
+
+unsigned long long DomainScheduler::getDispatchCount() const {
+    unsigned long long count = 0;
+    for (const auto& domain : domains) count += domain->getDispatchCount();
+    return count;
+}
+
+std::vector<unsigned long long> DomainScheduler::getCoreInstructionCounts() const {
+    std::vector<unsigned long long> result;
+    for (const auto& domain : domains) {
+        auto counts = domain->getCoreInstructionCounts();
+        result.insert(result.end(), counts.begin(), counts.end());
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<Process>> DomainScheduler::getRunningProcesses() const {
+    std::vector<std::shared_ptr<Process>> result;
+    for (const auto& domain : domains) {
+        auto running = domain->getRunningProcesses();
+        result.insert(result.end(), running.begin(), running.end());
+    }
+    return result;
+}
+
+std::shared_ptr<Process> DomainScheduler::stealReadyProcess() {
+    for (auto& domain : domains) {
+        if (auto proc = domain->stealReadyProcess()) return proc;
+    }
+    return nullptr;
+}
+
+// Each domain's capture runs the next domain's, so capture sees all of them locked together
+void DomainScheduler::captureQueues(const QueueCapture& capture) {
+    ReadyList ready;
+    SleepingList sleeping;
+    std::function<void(size_t)> captureFrom = [&](size_t index) {
+        if (index == domains.size()) {
+            capture(ready, sleeping);
+            return;
+        }
+        domains[index]->captureQueues([&](const ReadyList& domainReady, const SleepingList& domainSleeping) {
+            ready.insert(ready.end(), domainReady.begin(), domainReady.end());
+            sleeping.insert(sleeping.end(), domainSleeping.begin(), domainSleeping.end());
+            captureFrom(index + 1);
+        });
+    };
+    captureFrom(0);
+}
+
+void DomainScheduler::restoreSleeping(const std::shared_ptr<Process>& proc, unsigned long long ticks) {
+    domains[nextDomain++ % domains.size()]->restoreSleeping(proc, ticks);
+}
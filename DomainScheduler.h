@@ -0,0 +1,55 @@
+#pragma once
+#include "Scheduler.h"
+
+/*
+    Splits the cores into scheduling domains.
+    Each domain is a complete scheduler of the configured type (its own ready queue,
+    dispatcher thread and core threads) over a slice of the cores, so dispatch work and
+    queue contention stay bounded by the domain size instead of num-cpu.
+
+    New processes are handed to domains round robin. Every balanceInterval ms the
+    balancer compares queue lengths and, while the longest and shortest differ by more
+    than balanceThreshold, moves half the difference from the longest to the shortest.
+*/
+class DomainScheduler : public Scheduler {
+private:
+    std::vector<std::unique_ptr<Scheduler>> domains;
+    unsigned long long balanceInterval;
+    size_t balanceThreshold;
+
+    std::atomic<size_t> nextDomain{0};
+    std::atomic<unsigned long long> balancedMoves{0};
+    std::mutex balanceMutex;
+    std::condition_variable balanceCV;
+
+    void balance();
+
+public:
+    DomainScheduler(std::vector<std::unique_ptr<Scheduler>> domains, unsigned long long delay,
+                    unsigned long long balanceInterval, size_t balanceThreshold);
+    ~DomainScheduler();
+
+    void start() override;
+    void stop() override;
+    void schedulerLoop() override; // the load balancer
+    CoreTask coreWorker(int coreId) override;
+    void addProcess(const std::shared_ptr<Process>& proc) override;
+    void adoptProcess(const std::shared_ptr<Process>& proc) override;
+
+    int getBusyCoreCount() const override;
+    size_t getReadyQueueSize() const override;
+    size_t getWaitingCount() const override;
+    std::vector<CoreUtilization> getCoreUtilization(unsigned windowSeconds) const override;
+    std::vector<unsigned long long> getCoreInstructionCounts() const override;
+    std::vector<std::shared_ptr<Process>> getRunningProcesses() const override;
+    std::shared_ptr<Process> stealReadyProcess() override;
+    void captureQueues(const QueueCapture& capture) override; // every domain locked at once
+    void restoreSleeping(const std::shared_ptr<Process>& proc, unsigned long long ticks) override;
+    void setTraced(bool enabled) override;
+    unsigned long long getDispatchCount() const override;
+    size_t getSchedulerThreadCount() const override { return domains.size() + 1; }
+    void setSchedulerCpus(const std::vector<int>& cpus) override; // one per domain, then the balancer
+
+    size_t getDomainCount() const { return domains.size(); }
+    unsigned long long getBalancedMoves() const { return balancedMoves.load(); }
+};
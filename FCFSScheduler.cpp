@@ -1,6 +1,9 @@
 #include "FCFSScheduler.h"
+#include "CpuAffinity.h"
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <limits>
 
 FCFSScheduler::FCFSScheduler(int cores, unsigned long long delay) : Scheduler(cores, delay) {}
 
@@ -12,41 +15,57 @@ FCFSScheduler::~FCFSScheduler() {
 void FCFSScheduler::start() {
     running = true;
 
-    cores.reserve(coreCount);
+    // Create every core (up to the capacity addCores can grow to) before starting any
+    // worker, since workers index into cores
+    cores.reserve(coreCapacity);
+    for (int i = 0; i < coreCapacity; ++i) {
+        cores.push_back(std::make_unique<CPUCore>());
+    }
     for (int i = 0; i < coreCount; ++i) {
-        auto core = std::make_unique<CPUCore>();
-        core->thread = std::thread(&FCFSScheduler::coreWorker, this, i);
-        cores.push_back(std::move(core));
+        cores[i]->task = coreWorker(i);
+        CoreExecutor::shared().spawn(cores[i]->task);
     }
 
-    schedulerThread = std::thread(&FCFSScheduler::schedulerLoop, this);
+    schedulerThread = std::thread([this]() {
+        CpuAffinity::pinCurrentThread(schedulerCpu);
+        schedulerLoop();
+    });
+    startSleepTimer();
 }
 
-// Stop the scheduler and join all threads
+// Stop the scheduler and join the scheduler thread and every core
 void FCFSScheduler::stop() {
     running = false;
+    schedulerWake.notifyAll();
 
     for (auto& core : cores) {
-        std::unique_lock<std::mutex> lock(core->lock);
-        core->cv.notify_all();
+        core->wake.set();
     }
 
     if (schedulerThread.joinable()) schedulerThread.join();
     for (auto& core : cores) {
-        if (core->thread.joinable()) core->thread.join();
+        if (core->task.joinable()) core->task.join();
     }
+    stopSleepTimer();
 }
 
 // Add a process to the ready queue
 void FCFSScheduler::addProcess(const std::shared_ptr<Process>& proc) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    readyQueue.push(proc);
+    proc->transitionState(ProcessState::NEW, ProcessState::READY);
+    traceEvent(TraceEvent::Arrival, proc, -1);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        readyQueue.push(proc);
+    }
+    schedulerWake.notifyOne();
 }
 
 // Assigns processes to CPU cores (not busy) in a First-Come, First-Served manner
 void FCFSScheduler::schedulerLoop() {
     while (running) {
-        for (int i = 0; i < cores.size(); ++i) {
+        auto ticket = schedulerWake.prepareWait();
+        std::unique_lock<std::mutex> resizeLock(resizeMutex);
+        for (int i = 0; i < coreCount; ++i) {
             auto& core = cores[i];
             std::unique_lock<std::mutex> coreLock(core->lock);
 
@@ -63,58 +82,156 @@ void FCFSScheduler::schedulerLoop() {
                 if (nextProc) {
                     core->assignedProcess = nextProc;
                     core->busy = true;
-                    nextProc->setCoreNum(i);
-                    core->cv.notify_one();
+                    setCoreOccupied(i, true);
+                    nextProc->setCoreNum(coreOffset + i);
+                    nextProc->setState(ProcessState::RUNNING);
+                    traceEvent(TraceEvent::Dispatch, nextProc, i);
+                    core->wake.set();
                 }
             }
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        resizeLock.unlock();
+        schedulerWake.waitFor(ticket, std::chrono::milliseconds(1));
     }
 }
 
-// The core worker function that executes assigned processes 
-void FCFSScheduler::coreWorker(int coreId) {
+/*
+    The core worker that executes assigned processes. It is a CoreTask: while the core
+    is empty it waits on core->wake, and between bursts it yields (or waits out
+    delays-per-exec) so the host thread it shares can run other cores. core->lock is
+    never held across a co_await, since the task may resume on another host thread.
+*/
+CoreTask FCFSScheduler::coreWorker(int coreId) {
+    auto& executor = CoreExecutor::shared();
     auto& core = cores[coreId];
 
     while (running) {
         std::unique_lock<std::mutex> lock(core->lock);
-        core->cv.wait(lock, [&]() {
-            return core->assignedProcess != nullptr || !running;
-        });
+        while (core->assignedProcess == nullptr && running && !core->preemptRequested) {
+            lock.unlock();
+            co_await core->wake;
+            lock.lock();
+        }
 
         if (!running) break;
 
+        // Removed by removeCores and nothing left to drain
+        if (core->assignedProcess == nullptr) break;
+
         auto proc = core->assignedProcess;
         lock.unlock();
 
-        while (running && proc->getCompletedCommands() < proc->getTotalNoOfCommands()) {
+        // With a delay every instruction is followed by delayPerExec ticks, so run them one at a time;
+        // without one there is no slice, so pure loops may be skipped as far as they go
+        unsigned long long burstSize = delayPerExec > 0 ? 1 : BURST_SIZE;
+        unsigned long long stepBudget = delayPerExec > 0 ? 1 : std::numeric_limits<unsigned long long>::max();
+
+        unsigned long long sleepTicks = 0;
+        bool drained = false;
+        bool finished = false; // leaving because running went false is none of these
+
+        while (running) {
             int currentTick = getCoreTick(coreId);
-            
-            // Simulate execution delay from SLEEP instruction
-            if (proc->isSleeping(currentTick)) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-                incrementCoreTick(coreId);
-                continue;
-            }
 
             // NOTE: passing currentTick for SLEEP and FOR instruction
-            proc->executeInstruction(coreId, currentTick);
+            BurstResult burst = proc->executeBurst(coreOffset + coreId, currentTick, burstSize, 1, stepBudget);
+            addExecuted(coreId, burst.executed);
+            if (burst.reason == BurstEnd::Finished) {
+                traceEvent(TraceEvent::Finish, proc, coreId);
+                finished = true;
+                break;
+            }
+
+            // SLEEP: give the core up instead of waiting on it
+            if (burst.reason == BurstEnd::Sleeping) {
+                addCoreTicks(coreId, burst.executed);
+                sleepTicks = burst.sleepTicks;
+                traceEvent(TraceEvent::Sleep, proc, coreId);
+                break;
+            }
 
             // Simulate execution delay from delayPerExec
             if (delayPerExec > 0) {
                 for (int i = 0; i < delayPerExec; ++i) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    co_await executor.delay(std::chrono::milliseconds(1));
                     incrementCoreTick(coreId);
                 }
             } else {
-                incrementCoreTick(coreId);  // Only add 1 tick if no delay is set
+                addCoreTicks(coreId, burst.executed);  // 1 tick per instruction if no delay is set
+                co_await executor.yield();
+            }
+
+            // This core is being removed: stop between bursts and hand the process back
+            if (core->preemptRequested) {
+                drained = true;
+                break;
             }
         }
 
-        proc->setFinished(true);
+        if (finished) proc->setFinished(true);
         lock.lock();
         core->assignedProcess = nullptr;
         core->busy = false;
+        setCoreOccupied(coreId, false);
         lock.unlock();
+        schedulerWake.notifyOne(); // free for the next process
+
+        // Park it only after the core is free, so the wakeup can never find it still assigned here
+        if (sleepTicks > 0) {
+            proc->setCoreNum(-1);
+            sleepProcess(proc, sleepTicks);
+        }
+
+        if (drained) {
+            proc->setCoreNum(-1);
+            proc->transitionState(ProcessState::RUNNING, ProcessState::READY);
+            traceEvent(TraceEvent::Preempt, proc, coreId);
+            {
+                std::lock_guard<std::mutex> qLock(queueMutex);
+                readyQueue.push(proc);
+            }
+            schedulerWake.notifyOne();
+        }
+    }
+}
+
+int FCFSScheduler::addCores(int count) {
+    std::lock_guard<std::mutex> resizeLock(resizeMutex);
+    int from = coreCount;
+    int to = std::min(coreCapacity, from + std::max(0, count));
+
+    for (int i = from; i < to; ++i) {
+        cores[i]->preemptRequested = false;
+        cores[i]->task = coreWorker(i);
+        CoreExecutor::shared().spawn(cores[i]->task);
+    }
+    coreCount = to;
+    schedulerWake.notifyOne();
+    return to - from;
+}
+
+/*
+    Lowers coreCount first, so the dispatcher stops filling the removed cores, then asks
+    each of them to stop; a worker that is running a process finishes its current burst
+    and requeues it. Returns once every removed worker has exited.
+*/
+int FCFSScheduler::removeCores(int count) {
+    int from, to;
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        from = coreCount;
+        to = std::max(1, from - std::max(0, count));
+        coreCount = to;
+
+        for (int i = to; i < from; ++i) {
+            std::lock_guard<std::mutex> lock(cores[i]->lock);
+            cores[i]->preemptRequested = true;
+            cores[i]->wake.set();
+        }
+    }
+
+    for (int i = to; i < from; ++i) {
+        if (cores[i]->task.joinable()) cores[i]->task.join();
     }
+    return from - to;
 }
\ No newline at end of file
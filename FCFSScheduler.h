@@ -9,6 +9,9 @@ public:
     void start() override;
     void stop() override;
     void schedulerLoop() override;
-    void coreWorker(int coreId) override;
+    CoreTask coreWorker(int coreId) override;
     void addProcess(const std::shared_ptr<Process>& proc) override;
+
+    int addCores(int count) override;
+    int removeCores(int count) override;
 };
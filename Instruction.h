@@ -3,6 +3,13 @@
 #include <vector>
 #include <cstdint>
 
+// What ProgramImage's optional optimizer decided for an arithmetic instruction
+enum class Optimization : uint8_t {
+    None,     // executed as written
+    Dead,     // result is never read; only counted
+    Constant  // result is always constantValue; stored without reading operands
+};
+
 enum class InstructionType {
     PRINT,
     DECLARE,
@@ -39,5 +46,14 @@ struct Instruction {
     // For FOR loop
     std::vector<Instruction> loopInstructions;
     int loopRepeat = 0;
+
+    // Register slots of var1 / var2 / var3 (-1 = none), filled in by ProgramImage
+    int slot1 = -1;
+    int slot2 = -1;
+    int slot3 = -1;
+
+    // Filled in by ProgramImage when programs are optimized (optimize-programs)
+    Optimization optimization = Optimization::None;
+    uint16_t constantValue = 0;
 };
 
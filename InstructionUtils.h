@@ -19,10 +19,16 @@ inline std::string getRandomVarName() {
 }
 
 // Generate a timestamp in the format (MM/DD/YYYY HH:MM:SS AM/PM)
-// indicates execution time of the instruction
+// indicates execution time of the instruction.
+// The text only changes once a second, so each thread reuses its last one until then
 inline std::string generateCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     std::time_t now_c = std::chrono::system_clock::to_time_t(now);
+
+    thread_local std::time_t cachedSecond = -1;
+    thread_local std::string cachedTimestamp;
+    if (now_c == cachedSecond) return cachedTimestamp;
+
     std::tm local_time;
     localtime_s(&local_time, &now_c);
 
@@ -45,7 +51,9 @@ inline std::string generateCurrentTimestamp() {
               << std::setw(2) << std::setfill('0') << local_time.tm_sec << " "
               << ampm << ")";
 
-    return timestamp.str();
+    cachedSecond = now_c;
+    cachedTimestamp = timestamp.str();
+    return cachedTimestamp;
 }
 
 // for loop instruction generator
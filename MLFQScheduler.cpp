@@ -0,0 +1,99 @@
+#include "MLFQScheduler.h"
+#include <algorithm>
+
+MLFQScheduler::MLFQScheduler(int cores, int delay, unsigned long long quantum, int levels,
+                             const std::vector<unsigned long long>& multipliers, unsigned long long boost)
+    : RRScheduler(cores, delay, quantum), boostInterval(boost) {
+    if (levels < 1) levels = 1;
+    levelQueues.resize(levels);
+
+    // Missing multipliers keep doubling from the last one given
+    quantumMultipliers = multipliers;
+    if (quantumMultipliers.empty()) quantumMultipliers.push_back(1);
+    while (quantumMultipliers.size() < static_cast<size_t>(levels)) {
+        quantumMultipliers.push_back(quantumMultipliers.back() * 2);
+    }
+}
+
+// New processes start at the top, full quantum drops a level, early yield or SLEEP climbs one
+void MLFQScheduler::enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) {
+    int level = proc->getPriorityLevel();
+    int lowest = static_cast<int>(levelQueues.size()) - 1;
+
+    switch (reason) {
+        case RequeueReason::Arrival:
+            level = 0;
+            break;
+        case RequeueReason::QuantumExpired:
+            level = std::min(level + 1, lowest);
+            break;
+        case RequeueReason::Yielded:
+        case RequeueReason::Woken:
+            level = std::max(level - 1, 0);
+            break;
+        case RequeueReason::Preempted:
+        case RequeueReason::Migrated:
+            break;
+    }
+
+    proc->setPriorityLevel(level);
+    levelQueues[level].push_back(proc);
+}
+
+// Picks the front of the highest non-empty level. Boosts follow the system tick, since
+// each core's own clock starts from zero when it is added
+std::shared_ptr<Process> MLFQScheduler::dequeueReady(int coreId) {
+    unsigned long long tick = getSystemTick();
+    if (boostInterval > 0 && tick >= lastBoostTick + boostInterval) {
+        boostAll();
+        lastBoostTick = tick;
+    }
+
+    for (auto& queue : levelQueues) {
+        if (!queue.empty()) {
+            auto proc = queue.front();
+            queue.pop_front();
+            return proc;
+        }
+    }
+    return nullptr;
+}
+
+// Priority boost: everything goes back to level 0, keeping the current order
+void MLFQScheduler::boostAll() {
+    for (size_t level = 1; level < levelQueues.size(); ++level) {
+        for (auto& proc : levelQueues[level]) {
+            proc->setPriorityLevel(0);
+            levelQueues[0].push_back(proc);
+        }
+        levelQueues[level].clear();
+    }
+}
+
+// Load balancing gives away the least urgent work: the back of the lowest non-empty level
+std::shared_ptr<Process> MLFQScheduler::stealReady() {
+    for (auto level = levelQueues.rbegin(); level != levelQueues.rend(); ++level) {
+        if (!level->empty()) {
+            auto proc = level->back();
+            level->pop_back();
+            return proc;
+        }
+    }
+    return nullptr;
+}
+
+size_t MLFQScheduler::readyCount() const {
+    size_t count = 0;
+    for (const auto& queue : levelQueues) count += queue.size();
+    return count;
+}
+
+std::vector<std::shared_ptr<Process>> MLFQScheduler::readyList() const {
+    std::vector<std::shared_ptr<Process>> result;
+    for (const auto& queue : levelQueues) result.insert(result.end(), queue.begin(), queue.end());
+    return result;
+}
+
+unsigned long long MLFQScheduler::sliceLength(const std::shared_ptr<Process>& proc) const {
+    return quantumCycles * quantumMultipliers[proc->getPriorityLevel()];
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "RRScheduler.h"
+#include <deque>
+
+/*
+    Multi-level feedback queue.
+    Level 0 is the highest priority; each level is round robin with a quantum of
+    quantumCycles * multiplier[level]. A process that uses its whole quantum drops a
+    level, one that yields early (goes to SLEEP) moves up a level, and every
+    boostInterval ticks all processes are moved back to level 0 so long CPU-bound
+    jobs at the bottom cannot starve.
+*/
+class MLFQScheduler : public RRScheduler {
+private:
+    std::vector<std::deque<std::shared_ptr<Process>>> levelQueues;
+    std::vector<unsigned long long> quantumMultipliers;
+    unsigned long long boostInterval;
+    unsigned long long lastBoostTick = 0; // systemTick of the last boost
+
+    void boostAll();
+
+protected:
+    void enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) override;
+    std::shared_ptr<Process> dequeueReady(int coreId) override;
+    size_t readyCount() const override;
+    std::vector<std::shared_ptr<Process>> readyList() const override;
+    std::shared_ptr<Process> stealReady() override;
+    unsigned long long sliceLength(const std::shared_ptr<Process>& proc) const override;
+
+public:
+    MLFQScheduler(int cores, int delay, unsigned long long quantum, int levels,
+                  const std::vector<unsigned long long>& multipliers, unsigned long long boost);
+};
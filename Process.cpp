@@ -1,6 +1,10 @@
 #include "Process.h"
+#include "ProcessLogSink.h"
+#include "Checkpoint.h"
 
 #include <ctime>
+#include <algorithm>
+#include <stdexcept>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
@@ -10,6 +14,7 @@
 #define RESET  "\033[0m"
 
 int Process::NextProcessNum = 1;
+ProcessLogSink* Process::logSink = nullptr;
 
 Process::Process(std::string& pName, int totalCom)
 : processName(pName), totalNoOfCommands(totalCom) {
@@ -17,11 +22,18 @@ Process::Process(std::string& pName, int totalCom)
     setCompletedCommands(0);
     setCoreNum(-1);
     setProcessNum(NextProcessNum++);
-    setFinished(false);
 };
 
 // getters ---------------------------------------------------
 std::string Process::getTime() {
+    return formatTime(time);
+}
+
+std::string Process::getRawTime() const {
+    return formatRawTime(time);
+}
+
+std::string Process::formatTime(std::chrono::system_clock::time_point time) {
     auto now = std::chrono::system_clock::to_time_t(time);
     std::tm local_time;
     localtime_s(&local_time, &now);
@@ -63,7 +75,7 @@ std::string Process::getTime() {
 }
 
 // Returns the raw time in the format (MM/DD/YYYY HH:MM:SS AM/PM) w/o colors for logs
-std::string Process::getRawTime() const {
+std::string Process::formatRawTime(std::chrono::system_clock::time_point time) {
     auto now = std::chrono::system_clock::to_time_t(time);
     std::tm local_time;
     localtime_s(&local_time, &now);
@@ -96,18 +108,18 @@ std::string Process::getProcessName(){
     return this->processName;
 }
 
+// Counters below are the published copies, safe to read from any thread without locking
 unsigned long long Process::getTotalNoOfCommands(){
-    return this->totalNoOfCommands;
+    return publishedTotal.load(std::memory_order_relaxed);
     // return countExpandedInstructions(instructions);
 }
 
 unsigned long long Process::getCompletedCommands(){
-    return this->completedCommands;
+    return publishedCompleted.load(std::memory_order_relaxed);
 }
 
 int Process::getCoreNo(){
-    std::lock_guard<std::mutex> lock(processMutex);
-    return this->coreNum;
+    return publishedCoreNum.load(std::memory_order_relaxed);
 }
 
 int Process::getProcessNo(){
@@ -118,8 +130,57 @@ int Process::getNextProcessNum(){
     return NextProcessNum;
 }
 
+void Process::setLogSink(ProcessLogSink* sink){
+    logSink = sink;
+}
+
+void Process::setNextProcessNum(int num){
+    NextProcessNum = num;
+}
+
 bool Process::isFinished() {
-    return finished;
+    return state.load() == ProcessState::TERMINATED;
+}
+
+ProcessState Process::getState() const {
+    return state.load();
+}
+
+// Consistent copy of the published counters (see publishLocked)
+Process::ProcessSnapshot Process::getAtomicSnapshot() const {
+    ProcessSnapshot snapshot;
+    while (true) {
+        unsigned before = publishSeq.load(std::memory_order_acquire);
+        if (before & 1) continue; // writer in progress
+
+        snapshot.completedCommands = publishedCompleted.load(std::memory_order_relaxed);
+        snapshot.totalNoCommands = publishedTotal.load(std::memory_order_relaxed);
+        snapshot.coreNo = publishedCoreNum.load(std::memory_order_relaxed);
+        snapshot.migrations = publishedMigrations.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (publishSeq.load(std::memory_order_relaxed) == before) break;
+    }
+
+    snapshot.processName = processName;
+    snapshot.time = getRawTime();
+    snapshot.state = state.load();
+    snapshot.isRunning = snapshot.state == ProcessState::RUNNING;
+    return snapshot;
+}
+
+// Caller holds processMutex, which makes this the only writer
+void Process::publishLocked() {
+    unsigned seq = publishSeq.load(std::memory_order_relaxed);
+    publishSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    publishedCompleted.store(completedCommands, std::memory_order_relaxed);
+    publishedTotal.store(totalNoOfCommands, std::memory_order_relaxed);
+    publishedCoreNum.store(coreNum, std::memory_order_relaxed);
+    publishedMigrations.store(migrations, std::memory_order_relaxed);
+
+    publishSeq.store(seq + 2, std::memory_order_release);
 }
 
 // setters ----------------------------------------------------
@@ -131,16 +192,19 @@ void Process::setProcessName(const std::string& name){
 void Process::setTotalNoOfCommands(unsigned long long tCom){
     std::lock_guard<std::mutex> lock(processMutex);
     totalNoOfCommands = tCom;
+    publishLocked();
 }
 
 void Process::setCompletedCommands(unsigned long long cCom){
     std::lock_guard<std::mutex> lock(processMutex);
     completedCommands = cCom;
+    publishLocked();
 }
 
 void Process::setCoreNum(int cNum){
     std::lock_guard<std::mutex> lock(processMutex);
     coreNum = cNum;
+    publishLocked();
 }
 
 void Process::setProcessNum(int procNum){
@@ -148,9 +212,36 @@ void Process::setProcessNum(int procNum){
     processNum = procNum;
 }
 
+// Only marks a process finished; un-finishing is not a valid transition
 void Process::setFinished(bool fin) {
+    if (!fin) return;
     std::lock_guard<std::mutex> lock(processMutex);
-    finished = fin;
+    if (state.load() != ProcessState::TERMINATED) finishTime = std::chrono::system_clock::now();
+    setState(ProcessState::TERMINATED);
+}
+
+void Process::setState(ProcessState newState) {
+    noteStateChange(state.exchange(newState), newState);
+}
+
+bool Process::transitionState(ProcessState from, ProcessState to) {
+    if (!state.compare_exchange_strong(from, to)) return false;
+    noteStateChange(from, to);
+    return true;
+}
+
+// Only entering or leaving READY reads the clock
+void Process::noteStateChange(ProcessState from, ProcessState to) {
+    if (from == to || (from != ProcessState::READY && to != ProcessState::READY)) return;
+
+    long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (to == ProcessState::READY) {
+        readySince.store(now);
+        return;
+    }
+    long long since = readySince.exchange(-1);
+    if (since >= 0) readyNanos.fetch_add(now - since);
 }
 
 // INSTRUCTION RELATED FUNCTIONS -------------------------------
@@ -159,26 +250,48 @@ void Process::setFinished(bool fin) {
 bool Process::checkIfFinished() {
     // We lock processMutex to synchronize access to finished and coreNum
     std::lock_guard<std::mutex> lock(processMutex);
+    return checkIfFinishedLocked();
+}
 
+bool Process::checkIfFinishedLocked() {
     // Finish if completed commands reached or
     // instruction pointer is at end and no loops remain
-    if (completedCommands >= totalNoOfCommands) {
-        finished = true;
-        return true;
+    if (completedCommands < totalNoOfCommands && (instructionPointer < program->size() || !loopStack.empty())) {
+        return false;
     }
-    if (instructionPointer >= instructions.size() && loopStack.empty()) {
-        finished = true;
-        return true;
+    // finishTime is written before the state, so whoever sees TERMINATED can read it
+    if (state.load() != ProcessState::TERMINATED) {
+        finishTime = std::chrono::system_clock::now();
+        setState(ProcessState::TERMINATED);
     }
-    return false;
+    return true;
 }
 
 /*
     Adds an instruction to the process.
     This function appends the given instruction to the process's instruction list.
 */
+void Process::setProgram(std::shared_ptr<const ProgramImage> image) {
+    program = std::move(image);
+    registers.assign(program->getSymbols().size(), 0);
+}
+
+/*
+    The image may be shared with other processes, so appending builds a private copy.
+    Loop frames point into the current image, so this is only allowed before the process
+    has entered a FOR; replacing the image also ends earlier getInstructions() references.
+*/
 void Process::addInstruction(const Instruction& instr) {
-    instructions.push_back(instr);
+    std::lock_guard<std::mutex> lock(processMutex);
+    if (!loopStack.empty()) throw std::logic_error("addInstruction inside a FOR loop");
+    std::vector<Instruction> copy = program->getInstructions();
+    copy.push_back(instr);
+    program = std::make_shared<const ProgramImage>(std::move(copy));
+    registers.resize(program->getSymbols().size(), 0); // existing slots keep their numbers
+}
+
+std::shared_ptr<const ProgramImage> Process::getProgram() const {
+    return program;
 }
 
 // Check if the process is currently sleeping (due to a SLEEP instruction).
@@ -186,6 +299,27 @@ bool Process::isSleeping(int currentTick) const {
     return sleepUntilTick > currentTick;
 }
 
+bool Process::isWaiting() const {
+    return state.load() == ProcessState::WAITING;
+}
+
+/*
+    Called by the scheduler's sleep timer once the wake tick has passed.
+    The wake tick was set against the clock of the core that ran the SLEEP, so it
+    is cleared here rather than compared against whichever core runs the process next.
+*/
+void Process::wake() {
+    std::lock_guard<std::mutex> lock(processMutex);
+    sleepUntilTick = -1;
+    pendingSleepTicks = 0;
+    transitionState(ProcessState::WAITING, ProcessState::READY);
+}
+
+unsigned long long Process::getPendingSleepTicks() const {
+    std::lock_guard<std::mutex> lock(processMutex);
+    return pendingSleepTicks;
+}
+
 /*
     Executes instruction in the process.
     This function retrieves the next instruction from the process's instruction list
@@ -193,14 +327,108 @@ bool Process::isSleeping(int currentTick) const {
     process's state accordingly.
 */
 bool Process::executeInstruction(int coreId, int currentTick) {
-    Instruction instr;
+    std::lock_guard<std::mutex> lock(processMutex);
+    bool executed = executeInstructionLocked(coreId, currentTick);
+    publishLocked();
+    return executed;
+}
+
+/*
+    Runs up to maxInstructions instructions under a single processMutex acquisition,
+    instead of the scheduler locking once per instruction (and again for every
+    isSleeping / getCompletedCommands check in between).
+    ticksPerInstruction is how far the core's tick moves per instruction: 1 where the
+    tick counts instructions (FCFS), so a SLEEP partway through the burst wakes at the
+    same tick as it would one instruction at a time; 0 where ticks come from a clock (RR).
+    maxSteps (0 = maxInstructions) is what the caller's slice has left: whole iterations of
+    a pure arithmetic loop are skipped in closed form up to that many steps, while at most
+    maxInstructions are stepped one by one. The executed count (stepped and skipped) is
+    also added to quantumUsed.
+*/
+BurstResult Process::executeBurst(int coreId, int currentTick, unsigned long long maxInstructions,
+                                  int ticksPerInstruction, unsigned long long maxSteps) {
+    std::lock_guard<std::mutex> lock(processMutex);
+
+    maxSteps = std::max(maxSteps, maxInstructions);
+    unsigned long long executed = 0;
+    unsigned long long stepped = 0;
+    unsigned long long sleepTicks = 0;
+    BurstEnd reason = BurstEnd::QuantumExhausted;
+
+    while (stepped < maxInstructions && executed < maxSteps) {
+        int tick = currentTick + static_cast<int>(executed) * ticksPerInstruction;
+        if (isFinished()) {
+            reason = BurstEnd::Finished;
+            break;
+        }
+        if (sleepUntilTick > tick) {
+            reason = BurstEnd::Sleeping;
+            sleepTicks = sleepUntilTick - tick;
+            pendingSleepTicks = sleepTicks;
+            break;
+        }
+
+        // whole iterations of a pure arithmetic loop are applied at once
+        if (!loopStack.empty() && loopStack.back().summary != nullptr) {
+            unsigned long long skipped = fastForwardLoopLocked(maxSteps - executed);
+            if (skipped > 0) {
+                executed += skipped;
+                continue;
+            }
+        }
+
+        executeInstructionLocked(coreId, tick);
+        ++executed;
+        ++stepped;
+    }
+
+    if (isFinished()) reason = BurstEnd::Finished;
+    quantumUsed += static_cast<int>(executed);
+    publishLocked();
+    return {reason, executed, sleepTicks};
+}
+
+/*
+    If the innermost loop is a pure arithmetic FOR (ProgramImage's LoopSummary) about to
+    start an iteration, applies as many whole iterations as fit in maxSteps in closed form
+    and returns the steps they stand for (0 = step normally). Leaves the loop frame,
+    registers and completedCommands exactly as stepping would, at an iteration boundary,
+    so quanta still end on the same instruction. Stops short of the iteration that would
+    complete the process, which is left to the normal path.
+*/
+unsigned long long Process::fastForwardLoopLocked(unsigned long long maxSteps) {
+    auto& loop = loopStack.back();
+    if (loop.pointer != 0 && loop.pointer < loop.instructions->size()) return 0; // mid-iteration
+    const LoopSummary* summary = loop.summary;
+
+    // pointer == size: the previous iteration ended, the next call would start another
+    unsigned long long next = loop.pointer == 0 ? loop.currentRepeat : loop.currentRepeat + 1;
+    if (next >= static_cast<unsigned long long>(loop.repeatCount)) return 0;
+
+    unsigned long long iterations = std::min({loop.repeatCount - next, maxSteps / summary->stepsPerIteration,
+                                              summary->maxIterations()});
+    if (summary->commandsPerIteration > 0) {
+        if (completedCommands >= totalNoOfCommands) return 0;
+        iterations = std::min(iterations, (totalNoOfCommands - completedCommands - 1) / summary->commandsPerIteration);
+    }
+    if (iterations * summary->stepsPerIteration < FAST_FORWARD_MIN_STEPS) return 0;
+
+    summary->advance(registers.data(), iterations);
+    loop.pointer = loop.instructions->size();
+    loop.currentRepeat = next + iterations - 1;
+    completedCommands += iterations * summary->commandsPerIteration;
+    return iterations * summary->stepsPerIteration;
+}
+
+bool Process::executeInstructionLocked(int coreId, int currentTick) {
+    const Instruction* next;
 
     // Handle FOR loop stack
     if (!loopStack.empty()) {
         auto& loop = loopStack.back();
 
         // Finished current iteration?
-        if (loop.pointer >= loop.instructions.size()) {
+        if (loop.pointer >= loop.instructions->size()) {
             loop.pointer = 0;
             loop.currentRepeat++;
         }
@@ -208,50 +436,71 @@ bool Process::executeInstruction(int coreId, int currentTick) {
         // Exceeded loop repetition
         if (loop.currentRepeat >= loop.repeatCount) {
             loopStack.pop_back();
-            // After popping, call checkIfFinished in case process done now
-            checkIfFinished();
+            // After popping, call checkIfFinishedLocked in case process done now
+            checkIfFinishedLocked();
             return true;
         }
 
-        instr = loop.instructions[loop.pointer++];
+        next = &(*loop.instructions)[loop.pointer++];
     } else {
-        if (instructionPointer >= instructions.size()) {
+        if (instructionPointer >= program->size()) {
             // No instructions left
-            checkIfFinished();
+            checkIfFinishedLocked();
             return false;
         }
-        instr = instructions[instructionPointer++];
+        next = &program->getInstructions()[instructionPointer++];
     }
 
-    instr.executedTimestamp = generateCurrentTimestamp();
-    instr.executedCore = coreId;
+    // executed straight from the program; loop frames only point into it
+    const Instruction& instr = *next;
+
+    // variables live in registers by slot; an operand without a slot reads as an unset variable
+    auto operand = [this](bool immediate, uint16_t value, int slot) -> uint16_t {
+        if (immediate) return value;
+        return slot >= 0 ? registers[slot] : 0;
+    };
 
-    std::ostringstream log;
-    // Execute instruction and increment completedCommands for every executed instruction
+    // Execute instruction and increment completedCommands for every executed instruction.
+    // Only PRINT produces a log line, so only PRINT pays for the timestamp and formatting
     switch (instr.type) {
-        case InstructionType::PRINT:            
-            log << instr.executedTimestamp << "   Core: " << coreId << "   ";
+        case InstructionType::PRINT: {
+            std::ostringstream log;
+            log << generateCurrentTimestamp() << "   Core: " << coreId << "   ";
             log << "\"Hello world from " << processName << "!\" \n";
             completedCommands++; 
+
+            std::string line = log.str();
+            if (logSink && sinkLogging) logSink->push(coreId, processName, sinkSequence++, line);
+            appendLogLine(line);
             break;
+        }
 
         case InstructionType::DECLARE:
-            declareVariable(instr.var1, instr.value);
+            if (instr.optimization != Optimization::Dead) registers[instr.slot1] = instr.value;
             completedCommands++;
             break;
 
+        // an optimized program (ProgramImage::optimizeProgram) may have worked the result out already
         case InstructionType::ADD: {   
-            uint16_t val2 = instr.var2IsImmediate ? instr.var2ImmediateValue : getVariable(instr.var2);
-            uint16_t val3 = instr.var3IsImmediate ? instr.var3ImmediateValue : getVariable(instr.var3);
-            setVariable(instr.var1, val2 + val3);
+            if (instr.optimization == Optimization::Constant) {
+                registers[instr.slot1] = instr.constantValue;
+            } else if (instr.optimization == Optimization::None) {
+                uint16_t val2 = operand(instr.var2IsImmediate, instr.var2ImmediateValue, instr.slot2);
+                uint16_t val3 = operand(instr.var3IsImmediate, instr.var3ImmediateValue, instr.slot3);
+                registers[instr.slot1] = static_cast<uint16_t>(val2 + val3);
+            }
             completedCommands++;
             break;
         }
 
         case InstructionType::SUBTRACT: {
-            uint16_t val2 = instr.var2IsImmediate ? instr.var2ImmediateValue : getVariable(instr.var2);
-            uint16_t val3 = instr.var3IsImmediate ? instr.var3ImmediateValue : getVariable(instr.var3);
-            setVariable(instr.var1, val2 - val3);
+            if (instr.optimization == Optimization::Constant) {
+                registers[instr.slot1] = instr.constantValue;
+            } else if (instr.optimization == Optimization::None) {
+                uint16_t val2 = operand(instr.var2IsImmediate, instr.var2ImmediateValue, instr.slot2);
+                uint16_t val3 = operand(instr.var3IsImmediate, instr.var3ImmediateValue, instr.slot3);
+                registers[instr.slot1] = static_cast<uint16_t>(val2 - val3);
+            }
             completedCommands++;
             break;
         }
@@ -264,39 +513,50 @@ bool Process::executeInstruction(int coreId, int currentTick) {
         case InstructionType::FOR:
             // Push loop instructions and repetitions onto stack if valid
             if (!instr.loopInstructions.empty() && instr.loopRepeat > 0) {
-                loopStack.push_back({instr.loopInstructions, instr.loopRepeat, 0, 0});
+                loopStack.push_back({&instr.loopInstructions, instr.loopRepeat, 0, 0,
+                                     program->findLoop(&instr.loopInstructions)});
                 // DO NOT increment completedCommands here because the loop body will be counted
             }
             break;
     }
 
-    appendLogLine(log.str());
-    instr.hasExecuted = true;
-
     // After executing an instruction, check if process is finished
-    checkIfFinished();
+    checkIfFinishedLocked();
 
     return true;
 }
 
 // Declare a variable with an optional initial value
 void Process::declareVariable(const std::string& name, uint16_t value) {
-    variables[name] = value;
+    setVariable(name, value);
 }
 
 uint16_t Process::getVariable(const std::string& name) const {
-    auto it = variables.find(name);
+    int slot = program->findSymbol(name);
+    if (slot >= 0) return registers[slot];
+    auto it = variables.find(std::string_view(name));
     return (it != variables.end()) ? it->second : 0;
 }
 
+// The key is only built (in the arena) the first time a name outside the program is assigned
 void Process::setVariable(const std::string& name, uint16_t value) {
-    variables[name] = value;
+    int slot = program->findSymbol(name);
+    if (slot >= 0) {
+        registers[slot] = value;
+        return;
+    }
+    auto it = variables.find(std::string_view(name));
+    if (it != variables.end()) {
+        it->second = value;
+    } else {
+        variables.emplace(name, value);
+    }
 }
 
 // Get the current instruction based on the instruction pointer.
 const Instruction& Process::getCurrentInstruction() const {
-    if (instructionPointer < instructions.size()) {
-        return instructions[instructionPointer];
+    if (instructionPointer < program->size()) {
+        return program->getInstructions()[instructionPointer];
     } else {
         static Instruction dummy; // return default if out of bounds
         return dummy;
@@ -304,7 +564,7 @@ const Instruction& Process::getCurrentInstruction() const {
 }
 
 void Process::advanceInstructionPointer() {
-    if (instructionPointer < instructions.size())
+    if (instructionPointer < program->size())
         instructionPointer++;
 }
 
@@ -316,24 +576,131 @@ unsigned long long Process::getInstructionPointer() const {
     return instructionPointer;
 }
 
-std::vector<Instruction> Process::getInstructions() const {
-    return instructions;
+const std::vector<Instruction>& Process::getInstructions() const {
+    return program->getInstructions();
 }
 
 // Get the log lines generated by the process
 // This function returns a vector of strings containing the log lines.
 // Use for displaying the process's execution history.
 std::vector<std::string> Process::getLogLines() const {
-    return logLines;
+    std::lock_guard<std::mutex> lock(processMutex);
+    return std::vector<std::string>(logLines.begin(), logLines.end());
 }
 
 // Append a log line to the process's log
 void Process::appendLogLine(const std::string& line) {
-    logLines.push_back(line);
+    if (!line.empty()) logLines.emplace_back(line);
 }
 
 // Check if the process is currently running
-// A process is considered running if it is not finished and has a valid core number assigned.
+// A process is considered running while it is on a core (RUNNING state).
 bool Process::isRunning() const {
-    return !finished && coreNum != -1;
-}
\ No newline at end of file
+    return state.load() == ProcessState::RUNNING;
+}
+// Checkpoint ----------------------------------------------------
+
+void Process::writeCheckpoint(CheckpointWriter& out) const {
+    std::lock_guard<std::mutex> lock(processMutex);
+    out.text(processName);
+    out.i32(processNum);
+    out.u64(totalNoOfCommands);
+    out.u64(completedCommands);
+    out.i64(std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count());
+    out.u8(static_cast<uint8_t>(state.load()));
+
+    out.i32(instructionPointer);
+    out.i32(quantumUsed);
+    out.i32(priorityLevel);
+    out.i32(nice);
+    out.u64(vruntime);
+    out.i32(lastCore);
+    out.u64(migrations);
+    out.u64(pendingSleepTicks);
+
+    writeInstructions(out, program->getInstructions());
+
+    const auto& symbols = program->getSymbols();
+    out.u64(symbols.size() + variables.size());
+    for (size_t slot = 0; slot < symbols.size(); ++slot) {
+        out.interned(symbols[slot]);
+        out.u16(registers[slot]);
+    }
+    for (const auto& [name, value] : variables) {
+        out.interned(std::string(name));
+        out.u16(value);
+    }
+
+    // a frame's body is found again from the FOR its parent just stepped over
+    out.u64(loopStack.size());
+    for (const auto& loop : loopStack) {
+        out.i32(loop.repeatCount);
+        out.u64(loop.currentRepeat);
+        out.u64(loop.pointer);
+    }
+
+    out.u64(logLines.size());
+    for (const auto& line : logLines) out.text(line);
+}
+
+std::shared_ptr<Process> Process::readCheckpoint(CheckpointReader& in) {
+    std::string name = in.text();
+    int pid = in.i32();
+    unsigned long long total = in.u64();
+
+    auto proc = std::make_shared<Process>(name, static_cast<int>(total));
+    std::lock_guard<std::mutex> lock(proc->processMutex);
+    proc->processNum = pid;
+    proc->totalNoOfCommands = total;
+    proc->completedCommands = in.u64();
+    proc->time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(in.i64())));
+    uint8_t savedState = in.u8();
+    if (savedState > static_cast<uint8_t>(ProcessState::TERMINATED)) throw std::runtime_error("checkpoint has an unknown process state");
+    proc->state.store(static_cast<ProcessState>(savedState));
+    proc->finishTime = std::chrono::system_clock::now(); // not saved; retention restarts at restore
+
+    proc->instructionPointer = in.i32();
+    proc->quantumUsed = in.i32();
+    proc->priorityLevel = in.i32();
+    proc->nice = in.i32();
+    proc->vruntime = in.u64();
+    proc->lastCore = in.i32();
+    proc->migrations = in.u64();
+    proc->pendingSleepTicks = in.u64();
+
+    proc->setProgram(ProgramImage::intern(readInstructions(in)));
+
+    for (uint64_t i = 0, n = in.count(6); i < n; ++i) {
+        const std::string& variable = in.interned();
+        proc->setVariable(variable, in.u16());
+    }
+
+    proc->loopStack.resize(in.count(20));
+    const std::vector<Instruction>* body = nullptr;
+    unsigned long long forIndex = proc->instructionPointer;
+    for (auto& loop : proc->loopStack) {
+        const Instruction* loopFor = nullptr;
+        if (body == nullptr && forIndex > 0 && forIndex <= proc->program->size()) loopFor = &proc->program->getInstructions()[forIndex - 1];
+        if (body != nullptr && forIndex > 0 && forIndex <= body->size()) loopFor = &(*body)[forIndex - 1];
+        if (loopFor == nullptr || loopFor->type != InstructionType::FOR) throw std::runtime_error("checkpoint has a loop frame without its FOR");
+
+        body = &loopFor->loopInstructions;
+        loop.instructions = body;
+        loop.repeatCount = in.i32();
+        loop.currentRepeat = in.u64();
+        loop.pointer = in.u64();
+        loop.summary = proc->program->findLoop(body);
+        forIndex = loop.pointer;
+    }
+
+    for (uint64_t i = 0, n = in.count(sizeof(uint32_t)); i < n; ++i) proc->logLines.emplace_back(in.text());
+
+    // wake ticks are on the old cores' clocks; a SLEEPing process is restored with the
+    // ticks it had left instead (Scheduler::restoreSleeping), from the sleep queue or,
+    // if it was not parked yet, pendingSleepTicks
+    proc->sleepUntilTick = -1;
+    proc->coreNum = -1; // nothing is on a core after a restore
+    proc->publishLocked();
+    return proc;
+}
@@ -1,24 +1,92 @@
 #pragma once 
 #include "Instruction.h"
 #include "InstructionUtils.h"
+#include "ProgramImage.h"
 
 #include <unordered_map>
 #include <string>
 #include <fstream>
 #include <chrono>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+class ProcessLogSink;
+class CheckpointWriter;
+class CheckpointReader;
+
+/*
+    Process life cycle. Every change goes through an atomic store or compare-and-swap,
+    so readers (screen -ls, report-util) can check it without taking processMutex.
+        NEW -> READY             addProcess
+        READY -> RUNNING         dispatched to a core
+        RUNNING -> READY         quantum expired / preempted
+        RUNNING -> WAITING       SLEEP, parked on the scheduler's sleep queue
+        WAITING -> READY         wake tick reached
+        any -> TERMINATED        last instruction executed
+*/
+enum class ProcessState {
+    NEW,
+    READY,
+    RUNNING,
+    WAITING,
+    TERMINATED
+};
+
+// Why executeBurst stopped
+enum class BurstEnd {
+    QuantumExhausted, // ran maxInstructions
+    Sleeping,         // hit a SLEEP and the wake tick has not arrived
+    Finished          // no instructions left
+};
+
+struct BurstResult {
+    BurstEnd reason;
+    unsigned long long executed;        // instructions run by this burst
+    unsigned long long sleepTicks = 0;  // Sleeping: ticks left until the wake tick
+};
 
 class Process {
-    
+
+    /*
+    Per-process arena. The symbol table, loop frames and log lines are all
+    allocated from it instead of the global heap, so 128 cores and the batch generator
+    stop contending on one allocator for their small strings and nodes. The pool reuses
+    what a frame or rehash frees; underneath, the monotonic resource hands out blocks
+    that are only returned, all at once, when the process is destroyed.
+    Declared first so it outlives every container below.
+    */
+    static constexpr size_t ARENA_INITIAL_BLOCK = 4096;
+    static constexpr unsigned long long FAST_FORWARD_MIN_STEPS = 64; // fewer are cheaper to step
+    std::pmr::monotonic_buffer_resource arenaBlocks{ARENA_INITIAL_BLOCK};
+    std::pmr::unsynchronized_pool_resource arena{&arenaBlocks}; // only touched under processMutex
+
+    // Heterogeneous lookup: variables are found by std::string / string_view without building a key
+    struct VariableHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    // A loop frame points at the FOR body inside the program image rather than copying it
     struct LoopContext {
-        std::vector<Instruction> instructions;
+        const std::vector<Instruction>* instructions;
         int repeatCount;
         unsigned long long currentRepeat;
         unsigned long long pointer;
+        const LoopSummary* summary; // looked up once when the frame is pushed; nullptr = not pure
     };
-    std::vector<LoopContext> loopStack;
+    std::pmr::vector<LoopContext> loopStack{&arena};
 
     int quantumUsed = 0;
+    int priorityLevel = 0; // MLFQ queue level, 0 = highest
+    int nice = 0;                     // CFS nice value, -20 (most CPU) .. 19 (least)
+    unsigned long long vruntime = 0;  // CFS virtual runtime, weighted executed instructions
+
+    int lastCore = -1;                // core of the previous dispatch, kept after coreNum is reset
+    unsigned long long migrations = 0; // dispatches onto a different core than lastCore
     
     private:
         std::string processName;
@@ -26,37 +94,79 @@ class Process {
         unsigned long long completedCommands;
         int coreNum;
         int processNum;
-        std::ofstream logFile;
         std::chrono::time_point<std::chrono::system_clock> time;
+        std::chrono::time_point<std::chrono::system_clock> finishTime; // set once TERMINATED
+
+        std::atomic<ProcessState> state{ProcessState::NEW};
+
+        // Time spent READY, waiting for a core (compare); readySince is the steady clock in
+        // ns when the current READY stint began, -1 while not READY
+        std::atomic<long long> readySince{-1};
+        std::atomic<long long> readyNanos{0};
+        bool sinkLogging = true; // false: PRINT lines stay in memory, never reach logSink
+        uint32_t sinkSequence = 0; // lines pushed to logSink; the sink orders them by it across cores
 
-        bool finished = false;
+        void noteStateChange(ProcessState from, ProcessState to);
 
         static int NextProcessNum;
+        static ProcessLogSink* logSink; // optional, receives every PRINT line
 
-        // for instruction
-        std::vector<Instruction> instructions;
-        std::unordered_map<std::string, uint16_t> variables;
+        // for instruction: the shared, immutable program (ProgramImage) and this process's state in it
+        std::shared_ptr<const ProgramImage> program = ProgramImage::empty();
+        std::pmr::vector<uint16_t> registers{&arena}; // one per program symbol, by slot
+        // names the program itself never uses (set through declareVariable / setVariable)
+        std::pmr::unordered_map<std::pmr::string, uint16_t, VariableHash, std::equal_to<>> variables{&arena};
 
         int instructionPointer = 0;
         int sleepUntilTick = -1;
+        // ticks left when a burst last stopped on SLEEP, until wake(); lets a checkpoint taken
+        // before the scheduler parks the process keep the sleep (sleepUntilTick is per core)
+        unsigned long long pendingSleepTicks = 0;
 
-        std::vector<std::string> logLines;
+        std::pmr::vector<std::pmr::string> logLines{&arena};
 
         mutable std::mutex processMutex;
 
+        // executeInstruction / checkIfFinished bodies, caller holds processMutex
+        bool executeInstructionLocked(int coreId, int currentTick);
+        bool checkIfFinishedLocked();
+        unsigned long long fastForwardLoopLocked(unsigned long long maxSteps);
+
+        /*
+        Seqlock over the counters other threads display. The writer (always holding
+        processMutex, so there is only ever one) makes publishSeq odd, stores the
+        copies, then makes it even again; readers retry until they see the same even
+        value before and after reading. Readers never take processMutex, so a listing
+        cannot stall a core in the middle of a burst.
+        */
+        std::atomic<unsigned> publishSeq{0};
+        std::atomic<unsigned long long> publishedCompleted{0};
+        std::atomic<unsigned long long> publishedTotal{0};
+        std::atomic<unsigned long long> publishedMigrations{0};
+        std::atomic<int> publishedCoreNum{-1};
+
+        void publishLocked();
+
     public:
         Process(std::string& pName, int totalCom);
 
         //Getters
         std::string getTime();
         std::string getRawTime() const;
+        std::chrono::system_clock::time_point getCreationTime() const { return time; }
+        std::chrono::system_clock::time_point getFinishTime() const { return finishTime; } // valid once finished
+        static std::string formatTime(std::chrono::system_clock::time_point time);    // as getTime
+        static std::string formatRawTime(std::chrono::system_clock::time_point time); // as getRawTime
         std::string getProcessName();
         unsigned long long getTotalNoOfCommands();
         unsigned long long getCompletedCommands();
         int getCoreNo();
         int getProcessNo();
-        int getNextProcessNum();
+        static int getNextProcessNum();
+        static void setLogSink(ProcessLogSink* sink);
+        static void setNextProcessNum(int num); // restore: continue PIDs where the checkpoint left off
         bool isFinished();
+        ProcessState getState() const;
         
         //Setters
         void setProcessName(const std::string& name);
@@ -65,11 +175,22 @@ class Process {
         void setCoreNum(int coreNum);
         void setProcessNum(int procNum);
         void setFinished(bool fin);
+        void setState(ProcessState newState);
+        bool transitionState(ProcessState from, ProcessState to); // false if not currently in 'from'
+        void setSinkLogging(bool enabled) { sinkLogging = enabled; } // before the process is scheduled
+        std::chrono::nanoseconds getReadyTime() const { return std::chrono::nanoseconds(readyNanos.load()); } // finished READY stints
 
         // instruction
-        void addInstruction(const Instruction& instr);
+        void setProgram(std::shared_ptr<const ProgramImage> image); // before the process is scheduled
+        void addInstruction(const Instruction& instr); // copies the program first (copy-on-write)
+        std::shared_ptr<const ProgramImage> getProgram() const;
         bool executeInstruction(int coreId, int currentTick);
+        BurstResult executeBurst(int coreId, int currentTick, unsigned long long maxInstructions,
+                                 int ticksPerInstruction = 1, unsigned long long maxSteps = 0);
         bool isSleeping(int currentTick) const;
+        bool isWaiting() const;
+        void wake(); // SLEEP is over: clear the wake tick, WAITING -> READY
+        unsigned long long getPendingSleepTicks() const; // 0 unless stopped on a SLEEP not yet over
 
         void declareVariable(const std::string& name, uint16_t value = 0);
         uint16_t getVariable(const std::string& name) const;
@@ -80,12 +201,12 @@ class Process {
         void setSleepUntil(int tick);
  
         unsigned long long getInstructionPointer() const;
-        std::vector<Instruction> getInstructions() const;
+        const std::vector<Instruction>& getInstructions() const; // valid until addInstruction replaces the image
         std::vector<std::string> getLogLines() const;
         void appendLogLine(const std::string& line);
 
         // Atomic snapshot (to use for logging processList, ensures consistent reads
-        // of multiple fields avoiding data races
+        // of multiple fields avoiding data races). Read through the seqlock, lock-free
         struct ProcessSnapshot {
         std::string processName;
         bool isRunning;
@@ -93,19 +214,16 @@ class Process {
         unsigned long long completedCommands;
         unsigned long long totalNoCommands;
         std::string time;
+        unsigned long long migrations;
+        ProcessState state;
         };
 
-        ProcessSnapshot getAtomicSnapshot() const {
-        std::lock_guard<std::mutex> lock(processMutex);
-        return {
-            processName,
-            !finished && coreNum != -1,
-            coreNum,
-            completedCommands,
-            totalNoOfCommands,
-            getRawTime()
-            };
-        }
+        ProcessSnapshot getAtomicSnapshot() const;
+
+        // Checkpoint / restore (Checkpoint.h): everything needed to resume execution.
+        // readCheckpoint does not take a new PID; the process keeps the one it was saved with
+        void writeCheckpoint(CheckpointWriter& out) const;
+        static std::shared_ptr<Process> readCheckpoint(CheckpointReader& in);
         // ----------------------------------------------------------
 
         // to check if the process is still running
@@ -124,4 +242,44 @@ class Process {
         void incrementQuantumUsed() {
             ++quantumUsed;
         }
+
+        int getPriorityLevel() const {
+            return priorityLevel;
+        }
+
+        void setPriorityLevel(int level) {
+            priorityLevel = level;
+        }
+
+        int getNice() const {
+            return nice;
+        }
+
+        void setNice(int n) {
+            nice = n;
+        }
+
+        unsigned long long getVruntime() const {
+            return vruntime;
+        }
+
+        void setVruntime(unsigned long long v) {
+            vruntime = v;
+        }
+
+        int getLastCore() const {
+            return lastCore;
+        }
+
+        unsigned long long getMigrations() const {
+            return publishedMigrations.load(std::memory_order_relaxed);
+        }
+
+        // Call on every dispatch; counts a migration when the core differs from the last one
+        void recordDispatch(int core) {
+            std::lock_guard<std::mutex> lock(processMutex);
+            if (lastCore != -1 && lastCore != core) ++migrations;
+            lastCore = core;
+            publishLocked();
+        }
 };
\ No newline at end of file
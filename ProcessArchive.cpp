@@ -0,0 +1,67 @@
+#include "ProcessArchive.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+size_t ProcessArchive::reap(std::vector<std::shared_ptr<Process>>& processList, std::chrono::milliseconds retention,
+                            bool spillLogs) {
+    auto now = std::chrono::system_clock::now();
+    std::vector<ProcessRecord> reaped;
+
+    auto expired = [&](const std::shared_ptr<Process>& proc) {
+        if (!proc->isFinished() || now - proc->getFinishTime() < retention) return false;
+        if (spillLogs && !spill(*proc)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++spillFailures;
+        }
+
+        ProcessRecord record;
+        record.name = proc->getProcessName();
+        record.pid = proc->getProcessNo();
+        record.created = proc->getCreationTime();
+        record.finished = proc->getFinishTime();
+        record.completedCommands = proc->getCompletedCommands();
+        record.totalCommands = proc->getTotalNoOfCommands();
+        record.lastCore = proc->getLastCore();
+        record.migrations = proc->getMigrations();
+        reaped.push_back(std::move(record));
+        return true;
+    };
+    // keeps the survivors in creation order
+    processList.erase(std::remove_if(processList.begin(), processList.end(), expired), processList.end());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& record : reaped) records.push_back(std::move(record));
+    return reaped.size();
+}
+
+bool ProcessArchive::spill(Process& proc) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    std::ofstream file(std::filesystem::path(directory) / (proc.getProcessName() + ".txt"), std::ios::trunc);
+    if (!file) return false;
+    for (const auto& line : proc.getLogLines()) file << line;
+    return static_cast<bool>(file);
+}
+
+void ProcessArchive::append(ProcessRecord record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    records.push_back(std::move(record));
+}
+
+void ProcessArchive::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    records.clear();
+    spillFailures = 0;
+}
+
+size_t ProcessArchive::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return records.size();
+}
+
+unsigned long long ProcessArchive::getSpillFailures() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return spillFailures;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Process.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+
+// What is left of a process once it has been reaped: enough for screen -ls and report-util
+struct ProcessRecord {
+    std::string name;
+    int pid = 0;
+    std::chrono::system_clock::time_point created;
+    std::chrono::system_clock::time_point finished;
+    unsigned long long completedCommands = 0;
+    unsigned long long totalCommands = 0;
+    int lastCore = -1;
+    unsigned long long migrations = 0;
+};
+
+/*
+    Archive of finished processes (reap-retention).
+
+    reap() takes every process that has been finished for at least the retention out of
+    the process list and appends a ProcessRecord for it; once the scheduler lets go of
+    it too, the program reference, registers, loop frames and log lines are freed, so
+    memory follows the processes still alive rather than every process ever created.
+    With spillLogs the log lines are first written to <directory>/<name>.txt.
+
+    Records are only ever appended. Readers go through forEach, which holds the archive
+    lock while it walks them.
+*/
+class ProcessArchive {
+public:
+    ProcessArchive(const std::string& directory = "processArchive") : directory(directory) {}
+
+    // Caller holds whatever guards processList; returns how many processes were archived
+    size_t reap(std::vector<std::shared_ptr<Process>>& processList, std::chrono::milliseconds retention,
+                bool spillLogs);
+
+    void append(ProcessRecord record);
+    void clear();
+
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& record : records) fn(record);
+    }
+
+    size_t size() const;
+    unsigned long long getSpillFailures() const;
+
+private:
+    std::string directory;
+    mutable std::mutex mutex;
+    std::vector<ProcessRecord> records;
+    unsigned long long spillFailures = 0;
+
+    bool spill(Process& proc);
+};
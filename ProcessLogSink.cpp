@@ -0,0 +1,142 @@
+#include "ProcessLogSink.h"
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <string_view>
+
+ProcessLogSink::ProcessLogSink(int coreCount, size_t recordsPerCore, size_t maxOpenFiles,
+                               unsigned long long flushInterval, const std::string& directory)
+    : maxOpenFiles(std::max<size_t>(1, maxOpenFiles)), flushInterval(std::max(1ULL, flushInterval)),
+      directory(directory) {
+    // round up so the ring index is a mask instead of a modulo
+    size_t capacity = 1;
+    while (capacity < recordsPerCore) capacity <<= 1;
+    ringMask = capacity - 1;
+
+    for (int i = 0; i < std::max(1, coreCount); ++i) {
+        auto ring = std::make_unique<CoreRing>();
+        ring->records.resize(capacity);
+        rings.push_back(std::move(ring));
+    }
+}
+
+ProcessLogSink::~ProcessLogSink() {
+    stop();
+}
+
+// Starts from an empty log directory so files only hold this run
+void ProcessLogSink::start() {
+    if (running) return;
+
+    try {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    } catch (const std::filesystem::filesystem_error&) {
+        // files will fail to open and their records are simply lost
+    }
+
+    running = true;
+    writerThread = std::thread(&ProcessLogSink::writerLoop, this);
+}
+
+void ProcessLogSink::stop() {
+    if (!running.exchange(false)) return;
+
+    writerCV.notify_one();
+    if (writerThread.joinable()) writerThread.join();
+
+    drain();
+    openIndex.clear();
+    openFiles.clear();
+}
+
+bool ProcessLogSink::push(int coreId, const std::string& processName, uint32_t sequence, const std::string& line) {
+    if (line.empty()) return true;
+
+    CoreRing& ring = *rings[static_cast<size_t>(std::max(0, coreId)) % rings.size()];
+    size_t tail = ring.tail.load(std::memory_order_relaxed);
+    if (tail - ring.head.load(std::memory_order_acquire) > ringMask) {
+        ++dropped;
+        return false;
+    }
+
+    LogRecord& record = ring.records[tail & ringMask];
+    record.nameLength = static_cast<uint16_t>(std::min(processName.size(), NAME_SIZE));
+    record.textLength = static_cast<uint16_t>(std::min(line.size(), TEXT_SIZE));
+    record.sequence = sequence;
+    std::memcpy(record.processName, processName.data(), record.nameLength);
+    std::memcpy(record.text, line.data(), record.textLength);
+
+    ring.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+std::string ProcessLogSink::getLogFilePath(const std::string& processName) const {
+    return directory + "/" + processName + ".txt";
+}
+
+void ProcessLogSink::writerLoop() {
+    while (running) {
+        {
+            std::unique_lock<std::mutex> lock(writerMutex);
+            writerCV.wait_for(lock, std::chrono::milliseconds(flushInterval), [this] { return !running; });
+        }
+        drain();
+    }
+}
+
+/*
+    Collects every ring's pending records per process, sorts each process's records by
+    sequence and writes them in one go. The tails are all read before any record, so a
+    line printed after a migration is not taken while the one before it is left behind.
+    Records are read in place; the rings' heads only move once everything is written.
+    Only the writer thread (or stop, after joining it) calls this.
+*/
+void ProcessLogSink::drain() {
+    std::vector<size_t> tails(rings.size());
+    for (size_t i = 0; i < rings.size(); ++i) tails[i] = rings[i]->tail.load(std::memory_order_acquire);
+
+    std::unordered_map<std::string_view, std::vector<const LogRecord*>> pending;
+    unsigned long long count = 0;
+    for (size_t i = 0; i < rings.size(); ++i) {
+        for (size_t head = rings[i]->head.load(std::memory_order_relaxed); head != tails[i]; ++head) {
+            const LogRecord& record = rings[i]->records[head & ringMask];
+            pending[std::string_view(record.processName, record.nameLength)].push_back(&record);
+            ++count;
+        }
+    }
+
+    std::string text;
+    for (auto& [name, records] : pending) {
+        std::sort(records.begin(), records.end(),
+                  [](const LogRecord* a, const LogRecord* b) { return a->sequence < b->sequence; });
+        text.clear();
+        for (const LogRecord* record : records) text.append(record->text, record->textLength);
+
+        std::ofstream& out = openFile(std::string(name));
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        out.flush();
+    }
+
+    for (size_t i = 0; i < rings.size(); ++i) rings[i]->head.store(tails[i], std::memory_order_release);
+    written += count;
+}
+
+// Returns the stream for a process, closing the least recently used one if at the limit
+std::ofstream& ProcessLogSink::openFile(const std::string& processName) {
+    auto it = openIndex.find(processName);
+    if (it != openIndex.end()) {
+        openFiles.splice(openFiles.begin(), openFiles, it->second);
+        return openFiles.front().second;
+    }
+
+    if (openFiles.size() >= maxOpenFiles) {
+        openIndex.erase(openFiles.back().first);
+        openFiles.pop_back();
+    }
+
+    openFiles.emplace_front(processName, std::ofstream(getLogFilePath(processName), std::ios::app));
+    openIndex[processName] = openFiles.begin();
+    return openFiles.front().second;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <unordered_map>
+#include <condition_variable>
+
+/*
+    Persistent per-process execution logs (processLogs/<name>.txt).
+
+    Cores never touch the filesystem: executing a PRINT pushes one fixed-size record
+    into that core's ring buffer (single producer, single consumer, no locks). One
+    writer thread drains every ring each flushInterval ms, groups the text per process
+    and writes each group with a single call. A process that migrated between cores has
+    records in several rings, so each group is put back in the order the process
+    printed (its per-process sequence number) before it is written. At most
+    maxOpenFiles streams stay open; the least recently written one is closed to make room.
+
+    A full ring drops the record and counts it rather than stall the core.
+*/
+class ProcessLogSink {
+public:
+    static constexpr size_t NAME_SIZE = 32;
+    static constexpr size_t TEXT_SIZE = 88;
+
+    // 128 bytes; longer names or lines are truncated
+    struct LogRecord {
+        char processName[NAME_SIZE];
+        char text[TEXT_SIZE];
+        uint32_t sequence; // counts the process's lines, whichever core printed them
+        uint16_t nameLength;
+        uint16_t textLength;
+    };
+
+    ProcessLogSink(int coreCount, size_t recordsPerCore, size_t maxOpenFiles,
+                   unsigned long long flushInterval, const std::string& directory = "processLogs");
+    ~ProcessLogSink();
+
+    void start();
+    void stop(); // drains everything still buffered before returning
+
+    // Called from the core executing the process; never blocks. sequence increases with
+    // every line of that process
+    bool push(int coreId, const std::string& processName, uint32_t sequence, const std::string& line);
+
+    std::string getLogFilePath(const std::string& processName) const;
+    unsigned long long getDroppedCount() const { return dropped.load(); }
+    unsigned long long getWrittenCount() const { return written.load(); }
+
+private:
+    struct alignas(64) CoreRing {
+        std::vector<LogRecord> records;      // capacity is a power of two
+        alignas(64) std::atomic<size_t> head{0}; // next to read, owned by the writer
+        alignas(64) std::atomic<size_t> tail{0}; // next to write, owned by the core
+    };
+
+    std::vector<std::unique_ptr<CoreRing>> rings;
+    size_t ringMask;
+    size_t maxOpenFiles;
+    unsigned long long flushInterval;
+    std::string directory;
+
+    // open streams, most recently used at the front
+    std::list<std::pair<std::string, std::ofstream>> openFiles;
+    std::unordered_map<std::string, std::list<std::pair<std::string, std::ofstream>>::iterator> openIndex;
+
+    std::atomic<bool> running{false};
+    std::atomic<unsigned long long> dropped{0};
+    std::atomic<unsigned long long> written{0};
+    std::thread writerThread;
+    std::mutex writerMutex;
+    std::condition_variable writerCV;
+
+    void writerLoop();
+    void drain();
+    std::ofstream& openFile(const std::string& processName);
+};
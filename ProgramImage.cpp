@@ -0,0 +1,472 @@
+#include "ProgramImage.h"
+
+#include <string_view>
+#include <algorithm>
+
+std::atomic<bool> ProgramImage::optimizeNew{false};
+std::mutex ProgramImage::cacheMutex;
+std::unordered_multimap<size_t, std::weak_ptr<const ProgramImage>> ProgramImage::cache;
+size_t ProgramImage::pruneAt = 64;
+std::mutex ProgramImage::aliveMutex;
+size_t ProgramImage::aliveCount = 0;
+OptimizerStats ProgramImage::aliveOptimized;
+
+namespace {
+    void combine(size_t& seed, size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    // Loops touching more registers than this are stepped; the matrix would cost more than it saves
+    constexpr size_t MAX_SUMMARY_REGISTERS = 32;
+
+    // Square matrices of size n over uint16_t; wrapping unsigned arithmetic is arithmetic mod 2^16
+    using Matrix = std::vector<uint16_t>;
+
+    Matrix identity(size_t n) {
+        Matrix m(n * n, 0);
+        for (size_t i = 0; i < n; ++i) m[i * n + i] = 1;
+        return m;
+    }
+
+    Matrix multiply(const Matrix& a, const Matrix& b, size_t n) {
+        Matrix out(n * n, 0);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = 0; k < n; ++k) {
+                uint32_t aik = a[i * n + k];
+                if (aik == 0) continue;
+                for (size_t j = 0; j < n; ++j) {
+                    out[i * n + j] = static_cast<uint16_t>(out[i * n + j] + aik * b[k * n + j]);
+                }
+            }
+        }
+        return out;
+    }
+
+    Matrix power(Matrix base, unsigned long long exponent, size_t n) {
+        Matrix result = identity(n);
+        while (exponent > 0) {
+            if (exponent & 1) result = multiply(result, base, n);
+            exponent >>= 1;
+            if (exponent > 0) base = multiply(base, base, n);
+        }
+        return result;
+    }
+
+    bool isPureLoop(const Instruction& loop) {
+        for (const auto& instr : loop.loopInstructions) {
+            switch (instr.type) {
+                case InstructionType::DECLARE:
+                case InstructionType::ADD:
+                case InstructionType::SUBTRACT:
+                    break;
+                case InstructionType::FOR:
+                    if (!isPureLoop(instr)) return false;
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    void collectSlots(const std::vector<Instruction>& body, std::vector<int>& slots) {
+        for (const auto& instr : body) {
+            for (int slot : {instr.slot1, instr.slot2, instr.slot3}) {
+                if (slot >= 0 && std::find(slots.begin(), slots.end(), slot) == slots.end()) slots.push_back(slot);
+            }
+            if (instr.type == InstructionType::FOR) collectSlots(instr.loopInstructions, slots);
+        }
+    }
+
+    /*
+        Map of one pass over body, in the index space of slots (the constant is index n-1).
+        Row r of the running map holds register r as a combination of the values before
+        the pass; an instruction replaces its destination's row. Also counts the
+        executeInstruction calls and completed commands of the pass, the way
+        Process::executeInstructionLocked does: one call per instruction, a FOR counts a
+        call to push its frame and one to pop it, and only non-FOR instructions complete.
+    */
+    Matrix passMap(const std::vector<Instruction>& body, const std::vector<int>& slots,
+                   unsigned long long& steps, unsigned long long& commands) {
+        size_t n = slots.size() + 1;
+        Matrix map = identity(n);
+        auto index = [&](int slot) { return std::find(slots.begin(), slots.end(), slot) - slots.begin(); };
+
+        // operand as a row: a register's current row, or a constant
+        auto operandRow = [&](bool immediate, uint16_t value, int slot) {
+            std::vector<uint16_t> row(n, 0);
+            if (immediate) {
+                row[n - 1] = value;
+            } else if (slot >= 0) {
+                std::copy_n(map.begin() + index(slot) * n, n, row.begin());
+            }
+            return row;
+        };
+
+        steps = 0;
+        commands = 0;
+        for (const auto& instr : body) {
+            ++steps;
+            if (instr.type == InstructionType::FOR) {
+                if (instr.loopInstructions.empty() || instr.loopRepeat <= 0) continue; // never pushed
+                unsigned long long innerSteps = 0, innerCommands = 0;
+                Matrix inner = passMap(instr.loopInstructions, slots, innerSteps, innerCommands);
+                map = multiply(power(std::move(inner), instr.loopRepeat, n), map, n);
+                steps += instr.loopRepeat * innerSteps + 1;
+                commands += instr.loopRepeat * innerCommands;
+                continue;
+            }
+
+            std::vector<uint16_t> row(n, 0);
+            if (instr.type == InstructionType::DECLARE) {
+                row[n - 1] = instr.value;
+            } else {
+                auto a = operandRow(instr.var2IsImmediate, instr.var2ImmediateValue, instr.slot2);
+                auto b = operandRow(instr.var3IsImmediate, instr.var3ImmediateValue, instr.slot3);
+                for (size_t j = 0; j < n; ++j) {
+                    row[j] = static_cast<uint16_t>(instr.type == InstructionType::ADD ? a[j] + b[j] : a[j] - b[j]);
+                }
+            }
+            std::copy(row.begin(), row.end(), map.begin() + index(instr.slot1) * n);
+            ++commands;
+        }
+        return map;
+    }
+
+    // Known value of every register (UNKNOWN = depends on the path taken), for constant propagation
+    constexpr int32_t UNKNOWN = -1;
+    using Constants = std::vector<int32_t>;
+
+    void forgetWrites(const std::vector<Instruction>& body, Constants& known) {
+        for (const auto& instr : body) {
+            if (instr.type == InstructionType::FOR) forgetWrites(instr.loopInstructions, known);
+            else if (instr.slot1 >= 0 && instr.type != InstructionType::PRINT) known[instr.slot1] = UNKNOWN;
+        }
+    }
+
+    /*
+        Forward pass in execution order. A loop body is walked once with every register it
+        writes unknown on entry, which holds for every iteration, so what is constant there
+        is constant in all of them.
+    */
+    void propagateConstants(std::vector<Instruction>& body, Constants& known) {
+        auto operand = [&](bool immediate, uint16_t value, int slot) -> int32_t {
+            if (immediate) return value;
+            return slot >= 0 ? known[slot] : 0;
+        };
+
+        for (auto& instr : body) {
+            switch (instr.type) {
+                case InstructionType::DECLARE:
+                    known[instr.slot1] = instr.value;
+                    break;
+                case InstructionType::ADD:
+                case InstructionType::SUBTRACT: {
+                    int32_t a = operand(instr.var2IsImmediate, instr.var2ImmediateValue, instr.slot2);
+                    int32_t b = operand(instr.var3IsImmediate, instr.var3ImmediateValue, instr.slot3);
+                    if (a == UNKNOWN || b == UNKNOWN) {
+                        known[instr.slot1] = UNKNOWN;
+                        break;
+                    }
+                    instr.optimization = Optimization::Constant;
+                    instr.constantValue = static_cast<uint16_t>(instr.type == InstructionType::ADD ? a + b : a - b);
+                    known[instr.slot1] = instr.constantValue;
+                    break;
+                }
+                case InstructionType::FOR:
+                    if (instr.loopInstructions.empty() || instr.loopRepeat <= 0) break; // never pushed
+                    forgetWrites(instr.loopInstructions, known);
+                    propagateConstants(instr.loopInstructions, known);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    /*
+        Backward pass: live holds the registers some later PRINT may still read, and
+        becomes what is live before body. A store to a register that is not live is
+        dead. A loop body is live-out of what follows the loop plus what its own next
+        iteration reads, iterated to a fixed point before anything in it is marked;
+        the body runs at least once, so its stores do kill liveness. Constant
+        instructions no longer read their operands.
+    */
+    void markDeadStores(std::vector<Instruction>& body, std::vector<char>& live, bool mark) {
+        for (auto it = body.rbegin(); it != body.rend(); ++it) {
+            auto& instr = *it;
+            switch (instr.type) {
+                case InstructionType::PRINT:
+                    if (instr.slot1 >= 0) live[instr.slot1] = 1;
+                    break;
+                case InstructionType::DECLARE:
+                case InstructionType::ADD:
+                case InstructionType::SUBTRACT:
+                    if (!live[instr.slot1]) {
+                        if (mark) instr.optimization = Optimization::Dead;
+                        break;
+                    }
+                    live[instr.slot1] = 0;
+                    if (instr.type == InstructionType::DECLARE || instr.optimization == Optimization::Constant) break;
+                    if (instr.slot2 >= 0) live[instr.slot2] = 1;
+                    if (instr.slot3 >= 0) live[instr.slot3] = 1;
+                    break;
+                case InstructionType::FOR: {
+                    if (instr.loopInstructions.empty() || instr.loopRepeat <= 0) break;
+                    std::vector<char> out = live;
+                    while (true) {
+                        std::vector<char> in = out;
+                        markDeadStores(instr.loopInstructions, in, false);
+                        std::vector<char> merged = live;
+                        for (size_t i = 0; i < merged.size(); ++i) merged[i] |= in[i];
+                        if (merged == out) break;
+                        out = std::move(merged);
+                    }
+                    markDeadStores(instr.loopInstructions, out, mark);
+                    live = std::move(out);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+ProgramImage::ProgramImage(std::vector<Instruction> instructions, bool optimize)
+    : instructions(optimizeProgram(resolveSlots(std::move(instructions)), optimize)),
+      hash(hashProgram(this->instructions)), optimized(optimize) {
+    summarizeLoops(this->instructions); // keys are addresses inside the final, immutable program
+    countOptimized(this->instructions);
+    countAlive(true);
+}
+
+ProgramImage::~ProgramImage() {
+    countAlive(false);
+}
+
+// Keeps the report totals without walking the cache, which uncached images are not in
+void ProgramImage::countAlive(bool built) const {
+    if (instructions.empty()) return; // the shared empty() image is not a program
+    std::lock_guard<std::mutex> lock(aliveMutex);
+    if (built) {
+        ++aliveCount;
+        if (!optimized) return;
+        ++aliveOptimized.images;
+        aliveOptimized.instructions += instructionCount;
+        aliveOptimized.dead += deadCount;
+        aliveOptimized.constant += constantCount;
+    } else {
+        --aliveCount;
+        if (!optimized) return;
+        --aliveOptimized.images;
+        aliveOptimized.instructions -= instructionCount;
+        aliveOptimized.dead -= deadCount;
+        aliveOptimized.constant -= constantCount;
+    }
+}
+
+// Slots are numbered in program order, so appending an instruction keeps existing ones
+std::vector<Instruction> ProgramImage::resolveSlots(std::vector<Instruction> instructions) {
+    for (auto& instr : instructions) {
+        switch (instr.type) {
+            case InstructionType::PRINT:
+                if (!instr.var1.empty()) instr.slot1 = slotFor(instr.var1); // the variable it reports
+                break;
+            case InstructionType::DECLARE:
+                instr.slot1 = slotFor(instr.var1);
+                break;
+            case InstructionType::ADD:
+            case InstructionType::SUBTRACT:
+                instr.slot1 = slotFor(instr.var1);
+                if (!instr.var2IsImmediate) instr.slot2 = slotFor(instr.var2);
+                if (!instr.var3IsImmediate) instr.slot3 = slotFor(instr.var3);
+                break;
+            case InstructionType::FOR:
+                instr.loopInstructions = resolveSlots(std::move(instr.loopInstructions));
+                break;
+            default:
+                break;
+        }
+        instr.optimization = Optimization::None; // copies of an optimized program start over
+    }
+    return instructions;
+}
+
+/*
+    Constant propagation, then dead-store elimination, over the whole program. Registers
+    start at 0, and the only instruction that observes a variable is PRINT (var1), so a
+    store no PRINT can reach is dead: the process still counts it but never computes it,
+    and that variable's register (getVariable, checkpoints) keeps a stale value.
+    Pure loops are still skipped by their LoopSummary, which computes every register.
+*/
+std::vector<Instruction> ProgramImage::optimizeProgram(std::vector<Instruction> instructions, bool optimize) {
+    if (!optimize) return instructions;
+    Constants known(symbols.size(), 0);
+    propagateConstants(instructions, known);
+    std::vector<char> live(symbols.size(), 0);
+    markDeadStores(instructions, live, true);
+    return instructions;
+}
+
+void ProgramImage::countOptimized(const std::vector<Instruction>& instructions) {
+    for (const auto& instr : instructions) {
+        ++instructionCount;
+        if (instr.optimization == Optimization::Dead) ++deadCount;
+        else if (instr.optimization == Optimization::Constant) ++constantCount;
+        if (instr.type == InstructionType::FOR) countOptimized(instr.loopInstructions);
+    }
+}
+
+int ProgramImage::slotFor(const std::string& name) {
+    auto [it, inserted] = symbolIds.try_emplace(name, static_cast<int>(symbols.size()));
+    if (inserted) symbols.push_back(name);
+    return it->second;
+}
+
+void ProgramImage::summarizeLoops(const std::vector<Instruction>& instructions) {
+    for (const auto& instr : instructions) {
+        if (instr.type != InstructionType::FOR) continue;
+        summarizeLoops(instr.loopInstructions); // inner loops can be skipped on their own too
+
+        if (instr.loopInstructions.empty() || !isPureLoop(instr)) continue;
+        LoopSummary summary;
+        collectSlots(instr.loopInstructions, summary.slots);
+        if (summary.slots.size() > MAX_SUMMARY_REGISTERS) continue;
+        size_t n = summary.slots.size() + 1;
+        summary.powers.push_back(passMap(instr.loopInstructions, summary.slots, summary.stepsPerIteration,
+                                         summary.commandsPerIteration));
+        // advance() never applies more iterations than the loop repeats
+        while ((1ULL << summary.powers.size()) <= static_cast<unsigned long long>(instr.loopRepeat)) {
+            summary.powers.push_back(multiply(summary.powers.back(), summary.powers.back(), n));
+        }
+        loopSummaries.emplace(&instr.loopInstructions, std::move(summary));
+    }
+}
+
+const LoopSummary* ProgramImage::findLoop(const std::vector<Instruction>* body) const {
+    auto it = loopSummaries.find(body);
+    return it != loopSummaries.end() ? &it->second : nullptr;
+}
+
+// Powers of one matrix commute, so the squarings can be applied in any order
+void LoopSummary::advance(uint16_t* registers, unsigned long long iterations) const {
+    size_t n = slots.size() + 1;
+    std::vector<uint16_t> value(n, 1), next(n); // the last entry stays the constant 1
+    for (size_t i = 0; i < slots.size(); ++i) value[i] = registers[slots[i]];
+
+    for (size_t bit = 0; iterations > 0 && bit < powers.size(); ++bit, iterations >>= 1) {
+        if ((iterations & 1) == 0) continue;
+        const auto& step = powers[bit];
+        for (size_t i = 0; i < slots.size(); ++i) {
+            uint16_t sum = 0;
+            for (size_t j = 0; j < n; ++j) sum = static_cast<uint16_t>(sum + step[i * n + j] * static_cast<uint32_t>(value[j]));
+            next[i] = sum;
+        }
+        std::copy_n(next.begin(), slots.size(), value.begin());
+    }
+    for (size_t i = 0; i < slots.size(); ++i) registers[slots[i]] = value[i];
+}
+
+int ProgramImage::findSymbol(std::string_view name) const {
+    auto it = symbolIds.find(name);
+    return it != symbolIds.end() ? it->second : -1;
+}
+
+// Only the program fields; executedTimestamp / executedCore / hasExecuted are not part of it
+size_t ProgramImage::hashProgram(const std::vector<Instruction>& instructions, size_t seed) {
+    std::hash<std::string_view> text;
+    combine(seed, instructions.size());
+    for (const auto& instr : instructions) {
+        combine(seed, static_cast<size_t>(instr.type));
+        combine(seed, text(instr.message));
+        combine(seed, text(instr.var1));
+        combine(seed, text(instr.var2));
+        combine(seed, text(instr.var3));
+        combine(seed, (instr.var2IsImmediate ? 1 : 0) | (instr.var3IsImmediate ? 2 : 0));
+        combine(seed, (static_cast<size_t>(instr.var2ImmediateValue) << 16) | instr.var3ImmediateValue);
+        combine(seed, (static_cast<size_t>(instr.value) << 8) | instr.sleepTicks);
+        combine(seed, static_cast<size_t>(instr.loopRepeat));
+        if (instr.type == InstructionType::FOR) seed = hashProgram(instr.loopInstructions, seed);
+    }
+    return seed;
+}
+
+bool ProgramImage::sameProgram(const std::vector<Instruction>& a, const std::vector<Instruction>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const auto& x = a[i];
+        const auto& y = b[i];
+        if (x.type != y.type || x.message != y.message || x.var1 != y.var1 || x.var2 != y.var2 ||
+            x.var3 != y.var3 || x.var2IsImmediate != y.var2IsImmediate || x.var3IsImmediate != y.var3IsImmediate ||
+            x.var2ImmediateValue != y.var2ImmediateValue || x.var3ImmediateValue != y.var3ImmediateValue ||
+            x.value != y.value || x.sleepTicks != y.sleepTicks || x.loopRepeat != y.loopRepeat ||
+            !sameProgram(x.loopInstructions, y.loopInstructions)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::shared_ptr<const ProgramImage> ProgramImage::findCached(size_t hash, const std::vector<Instruction>& instructions,
+                                                             bool optimized) {
+    auto [first, last] = cache.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+        auto cached = it->second.lock();
+        if (cached && cached->optimized == optimized && sameProgram(cached->instructions, instructions)) return cached;
+    }
+    return nullptr;
+}
+
+/*
+    The raw program is hashed and looked up first: the hash and the comparison only read
+    program fields, which building (slots, optimizer, loop summaries) never changes, so a
+    hit costs no build at all. A miss is built outside the lock and looked up again before
+    it is inserted, in case another thread built the same program meanwhile.
+*/
+std::shared_ptr<const ProgramImage> ProgramImage::intern(std::vector<Instruction> instructions) {
+    bool optimize = optimizeNew.load();
+    size_t hash = hashProgram(instructions);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (auto cached = findCached(hash, instructions, optimize)) return cached;
+    }
+
+    auto image = std::make_shared<const ProgramImage>(std::move(instructions), optimize);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (auto cached = findCached(hash, image->instructions, optimize)) return cached;
+
+    // images whose processes are all gone leave expired entries; sweep them when the cache doubles
+    if (cache.size() >= pruneAt) {
+        for (auto it = cache.begin(); it != cache.end();) {
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+        }
+        pruneAt = std::max<size_t>(64, cache.size() * 2);
+    }
+    cache.emplace(image->hash, image);
+    return image;
+}
+
+std::shared_ptr<const ProgramImage> ProgramImage::create(std::vector<Instruction> instructions) {
+    return std::make_shared<const ProgramImage>(std::move(instructions), optimizeNew.load());
+}
+
+std::shared_ptr<const ProgramImage> ProgramImage::empty() {
+    static const auto image = std::make_shared<const ProgramImage>(std::vector<Instruction>{});
+    return image;
+}
+
+size_t ProgramImage::getAliveCount() {
+    std::lock_guard<std::mutex> lock(aliveMutex);
+    return aliveCount;
+}
+
+void ProgramImage::setOptimize(bool enabled) {
+    optimizeNew = enabled;
+}
+
+OptimizerStats ProgramImage::getOptimizerStats() {
+    std::lock_guard<std::mutex> lock(aliveMutex);
+    return aliveOptimized;
+}
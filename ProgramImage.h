@@ -0,0 +1,125 @@
+#pragma once
+#include "Instruction.h"
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <string>
+#include <string_view>
+
+/*
+    What one iteration of a pure arithmetic FOR does (its body, nested loops included,
+    only DECLAREs, ADDs and SUBTRACTs). Every such instruction is affine modulo 2^16, so
+    one iteration is the affine map  v' = M v + c  over the registers the loop touches,
+    and n iterations are M^n. The squarings M, M^2, M^4, ... up to the loop's repeat count
+    are computed once when the image is built, so advance() applies n iterations with one
+    matrix-vector product per set bit of n, O(k^2 log n) for k touched registers, instead
+    of stepping n times through the body.
+*/
+struct LoopSummary {
+    std::vector<int> slots;                  // registers the loop reads or writes
+    std::vector<std::vector<uint16_t>> powers; // M^(2^i), (k+1) x (k+1) row major; the last column is c
+    unsigned long long stepsPerIteration;    // executeInstruction calls one iteration takes
+    unsigned long long commandsPerIteration; // completedCommands one iteration adds
+
+    void advance(uint16_t* registers, unsigned long long iterations) const;
+    unsigned long long maxIterations() const { return (1ULL << powers.size()) - 1; } // advance() can apply
+};
+
+// Totals over the optimized images alive (report-util)
+struct OptimizerStats {
+    size_t images = 0;
+    unsigned long long instructions = 0; // FOR bodies counted once, not per iteration
+    unsigned long long dead = 0;
+    unsigned long long constant = 0;
+};
+
+/*
+    An immutable program, shared by every process that runs the same instructions.
+
+    intern() hashes the whole program (every field of every instruction, FOR bodies
+    included) and returns the image already cached for equal content; only on a miss is
+    a new image built and cached. The cache only holds weak references: an image lives
+    as long as some process uses it. create() builds an image without the cache, for
+    programs no other process can have: the random generator names every variable
+    uniquely, so generated programs never match and interning them would only cost a
+    hash, the lock and a cache entry. Processes keep their own instruction pointer, loop
+    frames and variables, and loop frames point into the image, so it is never modified
+    once built.
+
+    Building an image also gives every variable the program touches a register slot
+    (Instruction::slot1..3), so a process keeps its variables in a flat uint16_t array
+    indexed by slot instead of looking names up on every ADD / SUBTRACT / DECLARE,
+    and summarizes every pure arithmetic FOR (LoopSummary) so executeBurst can skip
+    whole iterations of it.
+
+    With setOptimize(true) (optimize-programs), images built afterwards are also run
+    through constant propagation and dead-store elimination (optimizeProgram), which
+    only annotates instructions (Instruction::optimization); the program and its hash
+    stay as written, and optimized and plain images of one program are cached apart.
+*/
+class ProgramImage {
+public:
+    explicit ProgramImage(std::vector<Instruction> instructions, bool optimize = false);
+    ~ProgramImage();
+
+    const std::vector<Instruction>& getInstructions() const { return instructions; }
+    size_t size() const { return instructions.size(); }
+    size_t getHash() const { return hash; }
+
+    const std::vector<std::string>& getSymbols() const { return symbols; } // name of each slot
+    int findSymbol(std::string_view name) const; // slot, or -1 if the program never uses the name
+
+    // Summary of the FOR whose body this is (a LoopContext's instructions), nullptr if not pure
+    const LoopSummary* findLoop(const std::vector<Instruction>* body) const;
+
+    static std::shared_ptr<const ProgramImage> intern(std::vector<Instruction> instructions);
+    static std::shared_ptr<const ProgramImage> create(std::vector<Instruction> instructions);
+    static std::shared_ptr<const ProgramImage> empty();
+
+    static size_t getAliveCount(); // non-empty images alive, cached or not
+
+    static void setOptimize(bool enabled); // for images built from now on
+    static OptimizerStats getOptimizerStats();
+
+private:
+    struct SymbolHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, int, SymbolHash, std::equal_to<>> symbolIds;
+    const std::vector<Instruction> instructions;
+    const size_t hash;
+    const bool optimized;
+    std::unordered_map<const std::vector<Instruction>*, LoopSummary> loopSummaries; // keyed by FOR body
+    unsigned long long instructionCount = 0;
+    unsigned long long deadCount = 0;
+    unsigned long long constantCount = 0;
+
+    static std::atomic<bool> optimizeNew;
+
+    static std::mutex cacheMutex;
+    static std::unordered_multimap<size_t, std::weak_ptr<const ProgramImage>> cache;
+    static size_t pruneAt; // cache size at which expired entries are swept out next
+
+    // every non-empty image adds itself when built and removes itself when destroyed
+    static std::mutex aliveMutex;
+    static size_t aliveCount;
+    static OptimizerStats aliveOptimized;
+    void countAlive(bool built) const;
+
+    std::vector<Instruction> resolveSlots(std::vector<Instruction> instructions);
+    int slotFor(const std::string& name);
+    std::vector<Instruction> optimizeProgram(std::vector<Instruction> instructions, bool optimize);
+    void countOptimized(const std::vector<Instruction>& instructions);
+    void summarizeLoops(const std::vector<Instruction>& instructions);
+
+    static size_t hashProgram(const std::vector<Instruction>& instructions, size_t seed = 0);
+    static bool sameProgram(const std::vector<Instruction>& a, const std::vector<Instruction>& b);
+    static std::shared_ptr<const ProgramImage> findCached(size_t hash, const std::vector<Instruction>& instructions,
+                                                          bool optimized); // caller holds cacheMutex
+};
@@ -1,208 +1,388 @@
 #include "RRScheduler.h"
+#include "CpuAffinity.h"
 #include <chrono>
 #include <thread>
 #include <iostream>
 #include <unordered_set>
+#include <algorithm>
 
 // Constructor
-RRScheduler::RRScheduler(int cores, int delay, unsigned long long quantum)
-    : Scheduler(cores, delay), quantumCycles(quantum) {}
+RRScheduler::RRScheduler(int cores, int delay, unsigned long long quantum, unsigned long long affinityWait)
+    : Scheduler(cores, delay), quantumCycles(quantum), affinityWait(affinityWait) {}
 
 // Start the Round Robin scheduler
 void RRScheduler::start() {
     running = true;
 
-    // Prepare CPU cores
-    cores.resize(coreCount);
-    tickThreads.resize(coreCount);
+    // Prepare CPU cores, up to the capacity addCores can grow to
+    cores.resize(coreCapacity);
+    tickTasks.resize(coreCapacity);
 
     // core assignments
-    coreThreads.resize(coreCount);
-    coreAssignments.resize(coreCount, nullptr);
+    sliceTasks.resize(coreCapacity);
+    coreAssignments.resize(coreCapacity, nullptr);
+    coreSlices.resize(coreCapacity, quantumCycles);
 
-    for (int i = 0; i < coreCount; ++i) {
+    for (int i = 0; i < coreCapacity; ++i) {
         auto core = std::make_unique<CPUCore>();
         core->busy = false;
         core->assignedProcess = nullptr;
         cores[i] = std::move(core);
     }
 
-    // Start tick threads
+    // Start core clocks
+    scanLimit = coreCount.load();
     for (int i = 0; i < coreCount; ++i) {
-        tickThreads[i] = std::thread([this, i]() {
-            while (running) {
-                incrementCoreTick(i);
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
-        });
+        startCoreClock(i);
+    }
+
+    schedulerThread = std::thread([this]() {
+        CpuAffinity::pinCurrentThread(schedulerCpu);
+        schedulerLoop();
+    });
+    startSleepTimer();
+}
+
+void RRScheduler::startCoreClock(int coreId) {
+    tickTasks[coreId] = runCoreClock(coreId);
+    CoreExecutor::shared().spawn(tickTasks[coreId]);
+}
+
+// A core's clock; it stops by itself once the core is removed
+CoreTask RRScheduler::runCoreClock(int coreId) {
+    auto& executor = CoreExecutor::shared();
+    while (running && coreId < coreCount) {
+        incrementCoreTick(coreId);
+        co_await executor.delay(std::chrono::milliseconds(1));
+    }
+}
+
+int RRScheduler::addCores(int count) {
+    std::lock_guard<std::mutex> resizeLock(resizeMutex);
+    int from = coreCount;
+    int to = std::min(coreCapacity, from + std::max(0, count));
+
+    coreCount = to; // before the clocks start, they run while their core is active
+    scanLimit = std::max(scanLimit.load(), to);
+    for (int i = from; i < to; ++i) {
+        if (tickTasks[i].joinable()) tickTasks[i].join();
+        startCoreClock(i);
+    }
+    schedulerWake.notifyOne();
+    return to - from;
+}
+
+/*
+    Lowers coreCount so nothing new is dispatched to the removed cores and ends their
+    running slices early; schedulerLoop keeps collecting cores up to scanLimit, so those
+    slices are requeued as Preempted the usual way. Returns once every removed core is empty.
+*/
+int RRScheduler::removeCores(int count) {
+    int from, to;
+    {
+        std::lock_guard<std::mutex> resizeLock(resizeMutex);
+        from = coreCount;
+        to = std::max(1, from - std::max(0, count));
+        coreCount = to;
+        for (int i = to; i < from; ++i) cores[i]->preemptRequested = true;
+    }
+    schedulerWake.notifyOne();
+
+    for (int i = to; i < from; ++i) {
+        while (running && coreCounters[i].occupied.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (tickTasks[i].joinable()) tickTasks[i].join();
     }
 
-    schedulerThread = std::thread(&RRScheduler::schedulerLoop, this);
+    std::lock_guard<std::mutex> resizeLock(resizeMutex);
+    scanLimit = coreCount.load();
+    return from - to;
 }
 
 // Stop the scheduler
 void RRScheduler::stop() {
     running = false;
 
-    schedulerCV.notify_all();
+    schedulerWake.notifyAll();
     if (schedulerThread.joinable()) schedulerThread.join();
 
-    // Join core threads - use the coreThreads vector from schedulerLoop
-    // Note: We need to ensure all threads are properly joined before cleanup
-    for (auto& core : cores) {
-        std::unique_lock<std::mutex> lock(core->lock);
-        core->cv.notify_all();
-    }
-
-    for (auto& t : coreThreads) {
+    // Join slices - use the sliceTasks vector from schedulerLoop
+    // Note: We need to ensure all slices are properly joined before cleanup
+    for (auto& t : sliceTasks) {
         if (t.joinable()) t.join();
     }
 
-    // Join tick threads
-    for (auto& t : tickThreads) {
+    // Join core clocks
+    for (auto& t : tickTasks) {
         if (t.joinable()) t.join();
     }
+    stopSleepTimer();
 
     // additional cleanup
-    for (int i = 0; i < coreCount; ++i) {
+    for (int i = 0; i < static_cast<int>(coreAssignments.size()); ++i) {
         coreAssignments[i] = nullptr;
         cores[i]->assignedProcess = nullptr;
         cores[i]->busy = false;
+        setCoreOccupied(i, false);
     }
 }
 
 // Add process to ready queue
 void RRScheduler::addProcess(const std::shared_ptr<Process>& proc) {
+    proc->transitionState(ProcessState::NEW, ProcessState::READY);
+    traceEvent(TraceEvent::Arrival, proc, -1);
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        readyQueue.push(proc);
+        enqueueReady(proc, RequeueReason::Arrival);
     }
-    schedulerCV.notify_one();
+    schedulerWake.notifyOne();
+}
+
+// Plain round robin: every process goes to the back of a single FIFO
+void RRScheduler::enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) {
+    if (affinityWait > 0) {
+        // lastCore is a global id; anything outside this scheduler's cores means no preference
+        int last = proc->getLastCore() - coreOffset;
+        if (last < 0 || last >= coreCount) last = -1; // includes removed cores
+        affinityQueue.push_back({proc, last, last >= 0 ? getCoreTick(last) : 0});
+        return;
+    }
+    readyQueue.push(proc);
+}
+
+/*
+    With affinity on, the queue is still FIFO but a core only takes an entry that
+    prefers it, has no preference, or has waited affinityWait ticks for its own core.
+    Only the first coreCount entries are looked at, so a dispatch never walks the
+    whole queue; if none qualify the core stays idle for this pass.
+*/
+std::shared_ptr<Process> RRScheduler::dequeueReady(int coreId) {
+    if (affinityWait > 0) {
+        size_t window = std::min(affinityQueue.size(), static_cast<size_t>(coreCount));
+        for (size_t i = 0; i < window; ++i) {
+            const auto& entry = affinityQueue[i];
+            bool eligible = entry.preferredCore < 0 || entry.preferredCore == coreId ||
+                            entry.preferredCore >= coreCount ||
+                            getCoreTick(entry.preferredCore) >= entry.queuedAt + affinityWait;
+            if (eligible) {
+                auto proc = entry.proc;
+                affinityQueue.erase(affinityQueue.begin() + i);
+                return proc;
+            }
+        }
+        return nullptr;
+    }
+
+    if (readyQueue.empty()) return nullptr;
+
+    auto proc = readyQueue.front();
+    readyQueue.pop();
+    return proc;
+}
+
+void RRScheduler::adoptProcess(const std::shared_ptr<Process>& proc) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        enqueueReady(proc, RequeueReason::Migrated);
+    }
+    schedulerWake.notifyOne();
+}
+
+// Policies decide what a wakeup is worth: MLFQ rewards it like a yield, SJF/SRTF treat it
+// as an arrival, CFS grants the sleeper credit
+void RRScheduler::wakeProcess(const std::shared_ptr<Process>& proc) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        enqueueReady(proc, RequeueReason::Woken);
+    }
+    schedulerWake.notifyOne();
+}
+
+std::shared_ptr<Process> RRScheduler::stealReadyProcess() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return stealReady();
+}
+
+// Takes the head of the queue regardless of affinity; it is leaving these cores anyway
+std::shared_ptr<Process> RRScheduler::stealReady() {
+    if (!affinityQueue.empty()) {
+        auto proc = affinityQueue.front().proc;
+        affinityQueue.pop_front();
+        return proc;
+    }
+    if (readyQueue.empty()) return nullptr;
+
+    auto proc = readyQueue.front();
+    readyQueue.pop();
+    return proc;
+}
+
+size_t RRScheduler::readyCount() const {
+    return readyQueue.size() + affinityQueue.size();
+}
+
+std::vector<std::shared_ptr<Process>> RRScheduler::readyList() const {
+    std::vector<std::shared_ptr<Process>> result;
+    for (const auto& entry : affinityQueue) result.push_back(entry.proc);
+    for (auto copy = readyQueue; !copy.empty(); copy.pop()) result.push_back(copy.front());
+    return result;
+}
+
+unsigned long long RRScheduler::sliceLength(const std::shared_ptr<Process>& proc) const {
+    return quantumCycles;
+}
+
+size_t RRScheduler::getReadyQueueSize() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return readyCount();
 }
 
 void RRScheduler::schedulerLoop() {
+    auto ticket = schedulerWake.prepareWait();
     while (running) {
-        std::unique_lock<std::mutex> schedLock(schedulerMutex);
-        schedulerCV.wait_for(schedLock, std::chrono::milliseconds(1), [this]() {
-            return !readyQueue.empty() || !running;
-        });
-
-        for (int core = 0; core < coreCount; ++core) {
-            // Join finished thread if process is finished
-            if (coreAssignments[core] && coreAssignments[core]->isFinished()) {
-                if (coreThreads[core].joinable()) {
-                    coreThreads[core].join();
+        if (getReadyQueueSize() == 0) schedulerWake.waitFor(ticket, std::chrono::milliseconds(1));
+        ticket = schedulerWake.prepareWait();
+
+        // Cores between coreCount and scanLimit are being removed: still collected, never filled
+        std::unique_lock<std::mutex> resizeLock(resizeMutex);
+        for (int core = 0; core < scanLimit; ++core) {
+            // Collect the slice once it has given the core back
+            if (coreAssignments[core] && cores[core]->sliceDone) {
+                if (sliceTasks[core].joinable()) {
+                    sliceTasks[core].join();
                 }
 
-                {
+                auto proc = coreAssignments[core];
+                onSliceEnd(proc, proc->getQuantumUsed());
+                if (proc->isFinished()) {
+                    traceEvent(TraceEvent::Finish, proc, core);
                     std::lock_guard<std::mutex> lock(cores[core]->lock);
                     cores[core]->busy = false;
-                    coreAssignments[core]->setCoreNum(-1);
-                    coreThreads[core] = std::thread(); // Reset
+                    cores[core]->assignedProcess = nullptr;
+                    setCoreOccupied(core, false);
+                    proc->setCoreNum(-1);
                     coreAssignments[core] = nullptr;
-                }
-                continue;
-            }
-
-            // Join thread if quantum exceeded but not finished
-            if (coreAssignments[core] &&
-                coreAssignments[core]->getQuantumUsed() >= quantumCycles) {
-                if (coreThreads[core].joinable()) {
-                    coreThreads[core].join();
+                    continue;
                 }
 
-                // Reset quantum, requeue
-                coreAssignments[core]->resetQuantumUsed();
-                {
-                    std::lock_guard<std::mutex> qLock(queueMutex);
-                    readyQueue.push(coreAssignments[core]);
-                }
-                coreThreads[core] = std::thread(); // Reset
-                coreAssignments[core] = nullptr;
-                {
-                    std::lock_guard<std::mutex> lock(cores[core]->lock);
-                    cores[core]->busy = false;
+                // Went to SLEEP: free the core now, wakeProcess requeues it at its wake tick
+                if (cores[core]->sleepTicks > 0) {
+                    traceEvent(TraceEvent::Sleep, proc, core);
+                    proc->resetQuantumUsed();
+                    proc->setCoreNum(-1);
+                    coreAssignments[core] = nullptr;
+                    {
+                        std::lock_guard<std::mutex> lock(cores[core]->lock);
+                        cores[core]->busy = false;
+                        cores[core]->assignedProcess = nullptr;
+                        setCoreOccupied(core, false);
+                    }
+                    sleepProcess(proc, cores[core]->sleepTicks);
+                } else {
+                    // Quantum exceeded (or preempted early) but not finished: requeue
+                    RequeueReason reason = RequeueReason::Yielded;
+                    if (cores[core]->preemptRequested) reason = RequeueReason::Preempted;
+                    else if (proc->getQuantumUsed() >= coreSlices[core]) reason = RequeueReason::QuantumExpired;
+                    proc->resetQuantumUsed();
+                    proc->transitionState(ProcessState::RUNNING, ProcessState::READY);
+                    traceEvent(TraceEvent::Preempt, proc, core);
+                    {
+                        std::lock_guard<std::mutex> qLock(queueMutex);
+                        enqueueReady(proc, reason);
+                    }
+                    coreAssignments[core] = nullptr;
+                    {
+                        std::lock_guard<std::mutex> lock(cores[core]->lock);
+                        cores[core]->busy = false;
+                        cores[core]->assignedProcess = nullptr;
+                        setCoreOccupied(core, false);
+                    }
+                    schedulerWake.notifyOne();
                 }
-                schedulerCV.notify_one();
             }
 
             // If core is idle, assign a new process
-            if (!coreAssignments[core] && !cores[core]->busy) {
+            if (core < coreCount && !coreAssignments[core] && !cores[core]->busy) {
                 std::shared_ptr<Process> nextProc = nullptr;
+                unsigned long long slice = 0;
                 {
+                    // the slice is sized in the same section since CFS reads its queued weight
                     std::lock_guard<std::mutex> qLock(queueMutex);
-                    if (!readyQueue.empty()) {
-                        nextProc = readyQueue.front();
-                        readyQueue.pop();
-                    }
+                    nextProc = dequeueReady(core);
+                    if (nextProc) slice = sliceLength(nextProc);
                 }
 
                 if (nextProc) {
                     coreAssignments[core] = nextProc;
-                    nextProc->setCoreNum(core);
+                    coreSlices[core] = slice;
+                    nextProc->setCoreNum(coreOffset + core);
+                    nextProc->recordDispatch(coreOffset + core);
+                    nextProc->setState(ProcessState::RUNNING);
+                    traceEvent(TraceEvent::Dispatch, nextProc, core);
                     {
                         std::lock_guard<std::mutex> lock(cores[core]->lock);
                         cores[core]->busy = true;
+                        cores[core]->assignedProcess = nextProc;
+                        setCoreOccupied(core, true);
                     }
 
                     nextProc->resetQuantumUsed();
-                    coreThreads[core] = std::thread([this, nextProc, core]() {
-                        unsigned long long ticks = 0;
-                        while (running && !nextProc->isFinished() && ticks < quantumCycles) {
-                            int tick = getCoreTick(core);
-
-                            if (nextProc->isSleeping(tick)) {
-                                std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                                continue;
-                            }
-
-                            nextProc->executeInstruction(core, tick);
-                            nextProc->incrementQuantumUsed();
-                            ++ticks;
-
-                            if (delayPerExec > 0) {
-                                for (int i = 0; i < delayPerExec; ++i) {
-                                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                                }
-                            }
-                        }
-                    });
+                    cores[core]->sliceDone = false;
+                    cores[core]->preemptRequested = false;
+                    cores[core]->sleepTicks = 0;
+                    sliceTasks[core] = runSlice(nextProc, core, coreSlices[core]);
+                    CoreExecutor::shared().spawn(sliceTasks[core]);
                 }
             }
         }
+
+        preemptIfNeeded();
     }
 
-    // Final join on all threads when stopping
-    for (int i = 0; i < coreCount; ++i) {
-        if (coreThreads[i].joinable()) coreThreads[i].join();
+    // Final join on all slices when stopping
+    for (int i = 0; i < static_cast<int>(sliceTasks.size()); ++i) {
+        if (sliceTasks[i].joinable()) sliceTasks[i].join();
     }
 }
 
+/*
+    One slice of proc on core. Between bursts it gives the host thread to other cores:
+    for delays-per-exec by waiting out the delay on the executor's timers, otherwise
+    by yielding, so one long slice cannot hold a shared host thread.
+*/
+CoreTask RRScheduler::runSlice(std::shared_ptr<Process> proc, int core, unsigned long long slice) {
+    auto& executor = CoreExecutor::shared();
+    unsigned long long ticks = 0;
+    unsigned long long burstSize = delayPerExec > 0 ? 1 : BURST_SIZE;
+    while (running && ticks < slice && !cores[core]->preemptRequested) {
+        int tick = getCoreTick(core);
 
-void RRScheduler::coreWorker(int coreId) {
-    // to work with scheduler base class
-}
+        // ticks here come from the core clocks, not from instructions. Pure loops may be
+        // skipped up to the rest of the slice; with a delay every step is paced instead
+        unsigned long long stepBudget = delayPerExec > 0 ? 1 : slice - ticks;
+        BurstResult burst = proc->executeBurst(coreOffset + core, tick, std::min(burstSize, slice - ticks), 0, stepBudget);
+        ticks += burst.executed;
+        addExecuted(core, burst.executed);
+        if (burst.reason == BurstEnd::Finished) break;
 
-// Override printing methods to use coreAssignments
-int RRScheduler::getBusyCoreCount() const {
-    int count = 0;
-    for (int i = 0; i < coreCount; ++i) {
-        if (coreAssignments[i] != nullptr && !coreAssignments[i]->isFinished()) {
-            count++;
+        // SLEEP ends the slice; schedulerLoop parks the process on the sleep queue
+        if (burst.reason == BurstEnd::Sleeping) {
+            cores[core]->sleepTicks = burst.sleepTicks;
+            break;
         }
-    }
-    return count;
-}
 
-std::vector<std::shared_ptr<Process>> RRScheduler::getRunningProcesses() const {
-    std::vector<std::shared_ptr<Process>> result;
-    
-    for (int i = 0; i < coreCount; ++i) {
-        if (coreAssignments[i] && 
-            coreAssignments[i]->getCompletedCommands() < coreAssignments[i]->getTotalNoOfCommands()) {
-            result.push_back(coreAssignments[i]);
+        if (delayPerExec > 0) {
+            co_await executor.delay(std::chrono::milliseconds(delayPerExec));
+        } else {
+            co_await executor.yield();
         }
     }
-    
-    return result;
+    cores[core]->sliceDone = true;
+    schedulerWake.notifyOne(); // the dispatcher collects the core
+}
+
+CoreTask RRScheduler::coreWorker(int coreId) {
+    // to work with scheduler base class
+    co_return;
 }
\ No newline at end of file
@@ -1,32 +1,81 @@
 #pragma once
 #include "Scheduler.h"
-#include <condition_variable>
 #include <queue>
 #include <mutex>
 #include <unordered_set>
+#include <deque>
 
 class RRScheduler : public Scheduler {
-private:
+protected:
+    // Why a process is being put (back) on the ready queue
+    enum class RequeueReason {
+        Arrival,        // new process from addProcess
+        QuantumExpired, // used its whole slice
+        Yielded,        // gave up the core early
+        Preempted,      // taken off the core by preemptIfNeeded
+        Migrated,       // moved here from another scheduling domain
+        Woken           // ready again after SLEEP
+    };
+
     std::queue<std::shared_ptr<Process>> readyQueue;
     unsigned long long quantumCycles;
-    std::condition_variable schedulerCV;
-    std::mutex schedulerMutex;
-    std::mutex assignLock;
-    mutable std::mutex assignmentsMutex; // Protect coreAssignments from race conditions
 
-    std::vector<std::thread> coreThreads;
+    // Soft affinity (affinityWait > 0): requeued processes wait up to affinityWait
+    // ticks of their last core for that core to pick them up before any idle core may
+    struct AffinityEntry {
+        std::shared_ptr<Process> proc;
+        int preferredCore;
+        unsigned long long queuedAt; // preferredCore's tick when queued
+    };
+    std::deque<AffinityEntry> affinityQueue;
+    unsigned long long affinityWait;
+
+    std::vector<CoreTask> sliceTasks; // each core's current slice
+    // schedulerLoop's view of each core; mirrored into cores[i]->assignedProcess under
+    // cores[i]->lock for readers on other threads (getRunningProcesses)
     std::vector<std::shared_ptr<Process>> coreAssignments;
+    std::vector<unsigned long long> coreSlices; // slice length given to each core's current process
     std::unordered_set<std::shared_ptr<Process>> assignedProcesses; // Track all assigned processes
+
+    // Cores schedulerLoop looks at: coreCount plus any still draining after removeCores
+    std::atomic<int> scanLimit{0};
+    void startCoreClock(int coreId);
+    CoreTask runCoreClock(int coreId);
+    CoreTask runSlice(std::shared_ptr<Process> proc, int core, unsigned long long slice);
+
+    /*
+    Ready queue policy. schedulerLoop calls these with queueMutex held, so
+    derived schedulers (MLFQ, ...) only have to decide where a process goes
+    and which one runs next; dispatching and slice tasks are shared.
+    */
+    virtual void enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason);
+    virtual std::shared_ptr<Process> dequeueReady(int coreId);
+    virtual size_t readyCount() const;
+    std::vector<std::shared_ptr<Process>> readyList() const override; // dispatch order, for checkpoints
+    virtual std::shared_ptr<Process> stealReady(); // for load balancing, no sleep/affinity checks
+    virtual unsigned long long sliceLength(const std::shared_ptr<Process>& proc) const;
+
+    // Called by schedulerLoop when a slice ends, before the process is requeued or released
+    virtual void onSliceEnd(const std::shared_ptr<Process>& proc, unsigned long long executed) {}
+
+    // Called once per scheduler pass after idle cores are filled; may set
+    // preemptRequested on a core to end its slice early. RR never preempts.
+    virtual void preemptIfNeeded() {}
+
+    void wakeProcess(const std::shared_ptr<Process>& proc) override;
+
 public:
-    RRScheduler(int cores, int delay, unsigned long long quantum);
+    RRScheduler(int cores, int delay, unsigned long long quantum, unsigned long long affinityWait = 0);
 
     void start() override;
     void stop() override;
     void schedulerLoop() override;
-    void coreWorker(int coreId) override;
+    CoreTask coreWorker(int coreId) override;
     void addProcess(const std::shared_ptr<Process>& proc) override;
-    
-    // Override printing methods to use coreAssignments
-    int getBusyCoreCount() const override;
-    std::vector<std::shared_ptr<Process>> getRunningProcesses() const override;
+    size_t getReadyQueueSize() const override;
+    std::shared_ptr<Process> stealReadyProcess() override;
+    void adoptProcess(const std::shared_ptr<Process>& proc) override;
+
+    int addCores(int count) override;
+    int removeCores(int count) override;
 };
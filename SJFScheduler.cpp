@@ -0,0 +1,80 @@
+#include "SJFScheduler.h"
+#include <limits>
+
+// quantumCycles is unused: slices only end on finish or preemption
+SJFScheduler::SJFScheduler(int cores, int delay, bool preemptive)
+    : RRScheduler(cores, delay, std::numeric_limits<unsigned long long>::max()), preemptive(preemptive) {}
+
+unsigned long long SJFScheduler::remainingOf(const std::shared_ptr<Process>& proc) {
+    unsigned long long total = proc->getTotalNoOfCommands();
+    unsigned long long done = proc->getCompletedCommands();
+    return done >= total ? 0 : total - done;
+}
+
+// Remaining work cannot change while a process waits, so the key is fixed at push time: O(log n)
+void SJFScheduler::enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) {
+    readyHeap.push({remainingOf(proc), nextSeq++, proc});
+    if (reason == RequeueReason::Arrival || reason == RequeueReason::Migrated || reason == RequeueReason::Woken) {
+        arrivedSinceCheck = true; // may be shorter than what is running now (SRTF)
+    }
+}
+
+std::shared_ptr<Process> SJFScheduler::dequeueReady(int coreId) {
+    if (readyHeap.empty()) return nullptr;
+
+    auto proc = readyHeap.top().proc;
+    readyHeap.pop();
+    return proc;
+}
+
+std::shared_ptr<Process> SJFScheduler::stealReady() {
+    return dequeueReady(-1);
+}
+
+size_t SJFScheduler::readyCount() const {
+    return readyHeap.size();
+}
+
+std::vector<std::shared_ptr<Process>> SJFScheduler::readyList() const {
+    std::vector<std::shared_ptr<Process>> result;
+    for (auto copy = readyHeap; !copy.empty(); copy.pop()) result.push_back(copy.top().proc);
+    return result;
+}
+
+unsigned long long SJFScheduler::sliceLength(const std::shared_ptr<Process>& proc) const {
+    return std::numeric_limits<unsigned long long>::max();
+}
+
+/*
+    SRTF preemption, only evaluated after new arrivals.
+    Idle cores have already been filled by the time this runs, so if the shortest
+    waiting process is shorter than the longest running one, the two swap places.
+*/
+void SJFScheduler::preemptIfNeeded() {
+    if (!preemptive || !arrivedSinceCheck.exchange(false)) return;
+
+    unsigned long long shortestWaiting;
+    {
+        std::lock_guard<std::mutex> qLock(queueMutex);
+        if (readyHeap.empty()) return;
+        shortestWaiting = readyHeap.top().remaining;
+    }
+
+    int victim = -1;
+    unsigned long long longestRunning = 0;
+    for (int core = 0; core < coreCount; ++core) {
+        auto& proc = coreAssignments[core];
+        if (!proc || cores[core]->sliceDone || cores[core]->preemptRequested) continue;
+
+        unsigned long long remaining = remainingOf(proc);
+        if (remaining > longestRunning) {
+            longestRunning = remaining;
+            victim = core;
+        }
+    }
+
+    if (victim != -1 && shortestWaiting < longestRunning) {
+        cores[victim]->preemptRequested = true;
+        arrivedSinceCheck = true; // re-check next pass in case more arrivals should get in
+    }
+}
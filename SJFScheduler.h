@@ -0,0 +1,45 @@
+#pragma once
+#include "RRScheduler.h"
+#include <queue>
+#include <vector>
+
+/*
+    Shortest job first, keyed on remaining instructions
+    (getTotalNoOfCommands() - getCompletedCommands()).
+
+    Non-preemptive ("sjf"): a dispatched process keeps its core until it finishes.
+    Preemptive ("srtf"): when a process arrives with less remaining work than the
+    longest process currently running, that process is preempted and requeued.
+*/
+class SJFScheduler : public RRScheduler {
+private:
+    struct HeapEntry {
+        unsigned long long remaining;
+        unsigned long long seq; // FIFO among equal remaining work
+        std::shared_ptr<Process> proc;
+
+        bool operator>(const HeapEntry& other) const {
+            if (remaining != other.remaining) return remaining > other.remaining;
+            return seq > other.seq;
+        }
+    };
+
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> readyHeap;
+    unsigned long long nextSeq = 0;
+    bool preemptive;
+    std::atomic<bool> arrivedSinceCheck{false};
+
+    static unsigned long long remainingOf(const std::shared_ptr<Process>& proc);
+
+protected:
+    void enqueueReady(const std::shared_ptr<Process>& proc, RequeueReason reason) override;
+    std::shared_ptr<Process> dequeueReady(int coreId) override;
+    size_t readyCount() const override;
+    std::vector<std::shared_ptr<Process>> readyList() const override;
+    std::shared_ptr<Process> stealReady() override;
+    unsigned long long sliceLength(const std::shared_ptr<Process>& proc) const override;
+    void preemptIfNeeded() override;
+
+public:
+    SJFScheduler(int cores, int delay, bool preemptive);
+};
@@ -0,0 +1,148 @@
+#include "SchedulerCompare.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+SchedulerCompare::SchedulerCompare(std::vector<CompareArrival> workload, Factory factory)
+    : workload(std::move(workload)), factory(std::move(factory)) {
+    std::stable_sort(this->workload.begin(), this->workload.end(),
+                     [](const CompareArrival& a, const CompareArrival& b) { return a.arrivalMs < b.arrivalMs; });
+}
+
+std::vector<CompareResult> SchedulerCompare::run(const std::vector<std::string>& schedulers) {
+    // engines and processes are built here, on the caller's thread, where the factory and
+    // the PID counter are safe to use; only the runs themselves are parallel
+    std::vector<std::unique_ptr<Scheduler>> engines;
+    std::vector<std::vector<std::shared_ptr<Process>>> processes;
+    for (const auto& type : schedulers) {
+        engines.push_back(factory(type));
+        processes.push_back(buildProcesses());
+    }
+
+    std::vector<CompareResult> results(schedulers.size());
+    std::vector<std::thread> runners;
+    for (size_t i = 0; i < schedulers.size(); ++i) {
+        runners.emplace_back([this, i, &schedulers, &engines, &processes, &results]() {
+            results[i] = runOne(schedulers[i], std::move(engines[i]), processes[i]);
+        });
+    }
+    for (auto& runner : runners) runner.join();
+    return results;
+}
+
+std::vector<std::shared_ptr<Process>> SchedulerCompare::buildProcesses() const {
+    int livePid = Process::getNextProcessNum();
+    std::vector<std::shared_ptr<Process>> processes;
+    processes.reserve(workload.size());
+    for (size_t i = 0; i < workload.size(); ++i) {
+        std::ostringstream name;
+        name << "p" << std::setw(2) << std::setfill('0') << i + 1;
+        std::string procName = name.str();
+
+        auto proc = std::make_shared<Process>(procName, static_cast<int>(workload[i].totalCommands));
+        proc->setProcessNum(static_cast<int>(i) + 1);
+        proc->setProgram(workload[i].program);
+        proc->setSinkLogging(false);
+        processes.push_back(std::move(proc));
+    }
+    Process::setNextProcessNum(livePid);
+    return processes;
+}
+
+/*
+    The feeder: adds every process once its arrival time has passed, checking every
+    millisecond like the batch generator, until all of them have finished or
+    RUN_TIMEOUT has passed. Metrics are taken while the engine still runs, before stop().
+*/
+CompareResult SchedulerCompare::runOne(const std::string& type, std::unique_ptr<Scheduler> scheduler,
+                                       const std::vector<std::shared_ptr<Process>>& processes) const {
+    CompareResult result;
+    result.scheduler = type;
+    result.processes = processes.size();
+    if (!scheduler) return result;
+    result.valid = true;
+
+    scheduler->setTraced(false);
+    scheduler->start();
+
+    std::vector<std::chrono::system_clock::time_point> arrivals(processes.size());
+    auto started = std::chrono::steady_clock::now();
+    size_t arrived = 0;
+    size_t finishedPrefix = 0;
+    while (std::chrono::steady_clock::now() - started < RUN_TIMEOUT) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        while (arrived < processes.size() && workload[arrived].arrivalMs <= static_cast<unsigned long long>(elapsed.count())) {
+            arrivals[arrived] = std::chrono::system_clock::now();
+            scheduler->addProcess(processes[arrived]);
+            ++arrived;
+        }
+
+        while (finishedPrefix < arrived && processes[finishedPrefix]->isFinished()) ++finishedPrefix;
+        if (finishedPrefix == processes.size()) break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Taken before stop(): a scheduler may wind down processes it was running, and those
+    // must not count as finished at the moment of the stop
+    auto toMs = [](auto duration) { return std::chrono::duration<double, std::milli>(duration).count(); };
+    std::vector<double> turnaround;
+    double waiting = 0;
+    auto lastFinish = arrivals.empty() ? std::chrono::system_clock::time_point() : arrivals.front();
+    for (size_t i = 0; i < arrived; ++i) {
+        if (!processes[i]->isFinished()) continue;
+        auto finish = processes[i]->getFinishTime();
+        turnaround.push_back(toMs(finish - arrivals[i]));
+        waiting += toMs(processes[i]->getReadyTime());
+        lastFinish = std::max(lastFinish, finish);
+    }
+    result.utilization = scheduler->getUtilization(0).busyPercent();
+    result.contextSwitches = scheduler->getDispatchCount();
+    scheduler->stop();
+
+    result.finished = turnaround.size();
+    if (turnaround.empty()) return result;
+
+    std::sort(turnaround.begin(), turnaround.end());
+    auto percentile = [&turnaround](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * turnaround.size()));
+        return turnaround[std::clamp<size_t>(rank, 1, turnaround.size()) - 1];
+    };
+    double total = 0;
+    for (double t : turnaround) total += t;
+
+    result.meanTurnaround = total / turnaround.size();
+    result.p95Turnaround = percentile(0.95);
+    result.p99Turnaround = percentile(0.99);
+    result.meanWaiting = waiting / turnaround.size();
+    result.makespanMs = toMs(lastFinish - arrivals.front());
+    if (result.makespanMs > 0) result.throughput = result.finished * 1000.0 / result.makespanMs;
+    return result;
+}
+
+void SchedulerCompare::printTable(std::ostream& out, const std::vector<CompareResult>& results) {
+    out << std::left << std::setw(11) << "Scheduler" << std::right
+        << std::setw(10) << "Finished" << std::setw(10) << "Proc/s"
+        << std::setw(12) << "Turn mean" << std::setw(11) << "Turn p95" << std::setw(11) << "Turn p99"
+        << std::setw(12) << "Wait mean" << std::setw(11) << "Switches" << std::setw(8) << "Util" << "\n";
+    out << std::string(96, '-') << "\n";
+
+    out << std::fixed << std::setprecision(1);
+    for (const auto& result : results) {
+        out << std::left << std::setw(11) << result.scheduler << std::right;
+        if (!result.valid) {
+            out << "  unknown scheduler\n";
+            continue;
+        }
+        std::string finished = std::to_string(result.finished) + "/" + std::to_string(result.processes);
+        out << std::setw(10) << finished << std::setw(10) << result.throughput
+            << std::setw(10) << result.meanTurnaround << "ms" << std::setw(9) << result.p95Turnaround << "ms"
+            << std::setw(9) << result.p99Turnaround << "ms" << std::setw(10) << result.meanWaiting << "ms"
+            << std::setw(11) << result.contextSwitches << std::setw(7) << result.utilization << "%\n";
+    }
+    out << std::defaultfloat;
+}
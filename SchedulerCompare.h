@@ -0,0 +1,71 @@
+#pragma once
+#include "Scheduler.h"
+#include "Process.h"
+#include "ProgramImage.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <ostream>
+#include <functional>
+
+// One process of a compare workload: when it arrives and what it runs
+struct CompareArrival {
+    unsigned long long arrivalMs; // after the run starts
+    std::shared_ptr<const ProgramImage> program;
+    unsigned long long totalCommands;
+};
+
+// What one scheduler made of the workload; times in ms
+struct CompareResult {
+    std::string scheduler;
+    bool valid = false;      // false if the factory knew no such scheduler
+    size_t processes = 0;
+    size_t finished = 0;     // the rest were still unfinished at RUN_TIMEOUT
+    double makespanMs = 0;   // first arrival to last finish
+    double throughput = 0;   // finished processes per second of makespan
+    double meanTurnaround = 0;
+    double p95Turnaround = 0;
+    double p99Turnaround = 0;
+    double meanWaiting = 0;  // time READY, waiting for a core
+    unsigned long long contextSwitches = 0; // dispatches onto a core
+    double utilization = 0;  // busy %, since the instance started
+};
+
+/*
+    Runs one workload through several schedulers side by side (the `compare` command).
+
+    Every scheduler gets its own engine instance from the factory, its own copies of the
+    processes (sharing the workload's program images) and its own feeder thread that
+    adds each process at its arrival time, and all of them run at once. The instances
+    share nothing but the core executor's host threads, are kept out of any active
+    trace and never write to the process log sink, so the live system is untouched
+    apart from the CPU time they take.
+
+    Turnaround is arrival to finish, waiting the time spent READY, so sleeping is
+    neither; tails are nearest-rank percentiles over the finished processes.
+*/
+class SchedulerCompare {
+public:
+    using Factory = std::function<std::unique_ptr<Scheduler>(const std::string& type)>;
+
+    static constexpr std::chrono::seconds RUN_TIMEOUT{120};
+
+    SchedulerCompare(std::vector<CompareArrival> workload, Factory factory);
+
+    // Blocks until every scheduler has finished the workload or timed out. The process
+    // copies are numbered 1..n and the live PID counter is put back afterwards, so call it
+    // while no other thread creates processes (batch generation stopped)
+    std::vector<CompareResult> run(const std::vector<std::string>& schedulers);
+
+    static void printTable(std::ostream& out, const std::vector<CompareResult>& results);
+
+private:
+    std::vector<CompareArrival> workload;
+    Factory factory;
+
+    std::vector<std::shared_ptr<Process>> buildProcesses() const;
+    CompareResult runOne(const std::string& type, std::unique_ptr<Scheduler> scheduler,
+                         const std::vector<std::shared_ptr<Process>>& processes) const;
+};
@@ -0,0 +1,75 @@
+#include "SchedulerTrace.h"
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+SchedulerTrace::SchedulerTrace(int coreCount, size_t recordsPerCore) : coreCount(std::max(1, coreCount)) {
+    for (int i = 0; i <= this->coreCount; ++i) {
+        auto buffer = std::make_unique<TraceBuffer>();
+        buffer->records.resize(std::max<size_t>(1, recordsPerCore));
+        buffers.push_back(std::move(buffer));
+    }
+}
+
+// Starts a fresh trace, discarding anything recorded before
+void SchedulerTrace::start() {
+    for (auto& buffer : buffers) buffer->next = 0;
+    dropped = 0;
+    startTime = std::chrono::steady_clock::now();
+    running = true;
+}
+
+/*
+    Off-core events and core ids outside the trace go to the shared buffer. The writers
+    count lets stop() know when no thread is still filling a slot it reserved.
+*/
+void SchedulerTrace::record(TraceEvent event, int pid, int core, unsigned long long tick) {
+    writers.fetch_add(1);
+    if (running.load()) {
+        TraceBuffer& buffer = *buffers[core >= 0 && core < coreCount ? core : coreCount];
+        size_t slot = buffer.next.fetch_add(1, std::memory_order_relaxed);
+
+        if (slot < buffer.records.size()) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            TraceRecord& rec = buffer.records[slot];
+            rec.timeMicros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+            rec.tick = tick;
+            rec.pid = static_cast<uint32_t>(pid);
+            rec.core = static_cast<int16_t>(core);
+            rec.event = static_cast<uint8_t>(event);
+            rec.reserved = 0;
+        } else {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    writers.fetch_sub(1, std::memory_order_release);
+}
+
+unsigned long long SchedulerTrace::getRecordedCount() const {
+    unsigned long long count = 0;
+    for (const auto& buffer : buffers) count += std::min(buffer->next.load(), buffer->records.size());
+    return count;
+}
+
+bool SchedulerTrace::stop(const std::string& filePath) {
+    running = false;
+    while (writers.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    TraceFileHeader header{};
+    std::copy(std::begin(MAGIC), std::end(MAGIC), header.magic);
+    header.version = VERSION;
+    header.coreCount = static_cast<uint32_t>(coreCount);
+    header.recordCount = getRecordedCount();
+    header.droppedCount = dropped.load();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& buffer : buffers) {
+        size_t count = std::min(buffer->next.load(), buffer->records.size());
+        out.write(reinterpret_cast<const char*>(buffer->records.data()),
+                  static_cast<std::streamsize>(count * sizeof(TraceRecord)));
+    }
+    return static_cast<bool>(out);
+}
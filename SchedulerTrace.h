@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+enum class TraceEvent : uint8_t {
+    Arrival,  // added to a ready queue
+    Dispatch, // put on a core
+    Preempt,  // taken off its core while still runnable (quantum, preemption, yield)
+    Sleep,    // taken off its core by SLEEP
+    Wake,     // SLEEP over, back on a ready queue
+    Finish    // last instruction done
+};
+
+/*
+    Binary scheduler event trace, enabled with `trace start` / `trace stop`.
+
+    Each core records into its own fixed buffer (plus one shared buffer for events that
+    happen off-core: arrivals and wakeups), reserving a slot with a single fetch_add, so
+    recording costs a few stores and never locks. A full buffer drops further events
+    and counts them. stop() waits for in-flight writers and dumps every buffer to one
+    file, which tools/trace_analyzer.cpp turns into timelines.
+
+    File layout (little endian): TraceFileHeader, then recordCount TraceRecords.
+*/
+struct TraceRecord {
+    uint64_t timeMicros; // since trace start
+    uint64_t tick;       // the core's tick, or the scheduler's system tick for off-core events
+    uint32_t pid;
+    int16_t core;        // global core id, -1 for off-core events
+    uint8_t event;       // TraceEvent
+    uint8_t reserved;
+};
+
+struct TraceFileHeader {
+    char magic[8];        // "CSTRACE"
+    uint32_t version;
+    uint32_t coreCount;
+    uint64_t recordCount;
+    uint64_t droppedCount;
+};
+
+class SchedulerTrace {
+public:
+    static constexpr char MAGIC[8] = "CSTRACE";
+    static constexpr uint32_t VERSION = 1;
+
+    SchedulerTrace(int coreCount, size_t recordsPerCore);
+
+    void start();
+    bool stop(const std::string& filePath); // false if the file could not be written
+
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+    void record(TraceEvent event, int pid, int core, unsigned long long tick);
+
+    unsigned long long getRecordedCount() const;
+    unsigned long long getDroppedCount() const { return dropped.load(); }
+
+private:
+    struct alignas(64) TraceBuffer {
+        std::vector<TraceRecord> records;
+        std::atomic<size_t> next{0};
+    };
+
+    int coreCount;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers; // coreCount per-core buffers + the off-core one
+    std::atomic<bool> running{false};
+    std::atomic<int> writers{0};
+    std::atomic<unsigned long long> dropped{0};
+    std::chrono::steady_clock::time_point startTime;
+};
@@ -0,0 +1,163 @@
+#include "TopView.h"
+#include "InstructionUtils.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <conio.h>
+
+#define ORANGE "\033[38;5;208m"
+#define RESET  "\033[0m"
+
+TopView::TopView(Scheduler& scheduler, unsigned long long refreshInterval)
+    : scheduler(scheduler), refreshInterval(std::max(50ULL, refreshInterval)) {}
+
+void TopView::run() {
+    std::cout << "\033[2J\033[?25l" << std::flush; // clear once, hide the cursor
+
+    previousCoreCounts = scheduler.getCoreInstructionCounts();
+    previousTime = std::chrono::steady_clock::now();
+
+    while (!_kbhit()) {
+        draw(buildFrame());
+
+        // poll the keyboard in small steps so a key press is not held up by a long refresh
+        auto wakeAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(refreshInterval);
+        while (std::chrono::steady_clock::now() < wakeAt && !_kbhit()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    _getch();
+
+    std::cout << "\033[" << previousFrame.size() + 1 << ";1H\033[?25h\n" << std::flush;
+}
+
+std::vector<std::string> TopView::buildFrame() {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::max(1e-3, std::chrono::duration<double>(now - previousTime).count());
+    previousTime = now;
+
+    auto coreCounts = scheduler.getCoreInstructionCounts();
+    auto running = scheduler.getRunningProcesses();
+
+    std::vector<std::string> frame;
+    std::ostringstream line;
+    auto push = [&]() {
+        frame.push_back(line.str());
+        line.str("");
+    };
+
+    line << "top - " << generateCurrentTimestamp() << "   refresh " << refreshInterval
+         << " ms   press any key to exit";
+    push();
+
+    line << std::fixed << std::setprecision(0)
+         << "CPU: " << std::setw(3) << scheduler.getUtilization(1).busyPercent() << "% (1s) "
+         << std::setw(3) << scheduler.getUtilization(10).busyPercent() << "% (10s) "
+         << std::setw(3) << scheduler.getUtilization(60).busyPercent() << "% (60s)   "
+         << "busy cores: " << scheduler.getBusyCoreCount() << "/" << scheduler.getCoreCount();
+    push();
+
+    unsigned long long totalRate = 0;
+    std::vector<unsigned long long> coreRates(coreCounts.size(), 0);
+    for (size_t i = 0; i < coreCounts.size(); ++i) {
+        unsigned long long before = i < previousCoreCounts.size() ? previousCoreCounts[i] : 0;
+        coreRates[i] = static_cast<unsigned long long>((coreCounts[i] - std::min(before, coreCounts[i])) / seconds);
+        totalRate += coreRates[i];
+    }
+    previousCoreCounts = coreCounts;
+
+    line << "Ready: " << scheduler.getReadyQueueSize() << "   sleeping: " << scheduler.getWaitingCount()
+         << "   running: " << running.size() << "   throughput: " << totalRate << " instr/s";
+    push();
+    push();
+
+    // what each core runs; running processes know their global core id
+    std::vector<const Process::ProcessSnapshot*> onCore(coreCounts.size(), nullptr);
+    std::vector<Process::ProcessSnapshot> snapshots;
+    snapshots.reserve(running.size());
+    for (const auto& proc : running) snapshots.push_back(proc->getAtomicSnapshot());
+    for (const auto& snapshot : snapshots) {
+        if (snapshot.coreNo >= 0 && snapshot.coreNo < static_cast<int>(onCore.size())) onCore[snapshot.coreNo] = &snapshot;
+    }
+
+    line << "CORE  PROCESS     INSTR/S";
+    push();
+    for (size_t i = 0; i < coreCounts.size(); ++i) {
+        std::string name = onCore[i] ? onCore[i]->processName : "-";
+        line << std::left << "C" << std::setw(4) << i << " " << std::setw(10) << name.substr(0, 10)
+             << std::right << std::setw(9) << coreRates[i] << "    ";
+        if ((i + 1) % CORES_PER_ROW == 0 || i + 1 == coreCounts.size()) push();
+    }
+    push();
+
+    // busiest: most instructions since the last refresh among the processes on a core now
+    struct Busy { size_t index; unsigned long long rate; };
+    std::vector<Busy> busiest;
+    std::unordered_map<int, unsigned long long> completedNow;
+    for (size_t i = 0; i < running.size(); ++i) {
+        int pid = running[i]->getProcessNo();
+        unsigned long long done = snapshots[i].completedCommands;
+        auto it = previousCompleted.find(pid);
+        unsigned long long before = it != previousCompleted.end() ? std::min(it->second, done) : done;
+        busiest.push_back({i, static_cast<unsigned long long>((done - before) / seconds)});
+        completedNow[pid] = done;
+    }
+    previousCompleted = std::move(completedNow);
+
+    size_t shown = std::min(BUSIEST_SHOWN, busiest.size());
+    std::partial_sort(busiest.begin(), busiest.begin() + shown, busiest.end(),
+                      [](const Busy& a, const Busy& b) { return a.rate > b.rate; });
+
+    line << "Busiest processes:";
+    push();
+    line << std::left << std::setw(8) << "PID" << std::setw(12) << "NAME" << std::right
+         << std::setw(10) << "INSTR/S" << std::setw(20) << "PROGRESS" << std::setw(8) << "CORE";
+    push();
+    for (size_t i = 0; i < BUSIEST_SHOWN; ++i) {
+        if (i < shown) {
+            const auto& snapshot = snapshots[busiest[i].index];
+            std::ostringstream progress;
+            progress << snapshot.completedCommands << " / " << snapshot.totalNoCommands;
+            line << std::left << std::setw(8) << running[busiest[i].index]->getProcessNo()
+                 << std::setw(12) << snapshot.processName.substr(0, 11) << std::right
+                 << std::setw(10) << busiest[i].rate << std::setw(20) << progress.str()
+                 << std::setw(8) << snapshot.coreNo;
+        }
+        push(); // keep the table height fixed so rows below never move
+    }
+
+    return frame;
+}
+
+/*
+    Rewrites only what changed: for every line, the span from the first to the last
+    character that differs from the previous frame (cursor positioned with ANSI escapes).
+*/
+void TopView::draw(const std::vector<std::string>& frame) {
+    std::string out;
+    size_t lines = std::max(frame.size(), previousFrame.size());
+
+    for (size_t row = 0; row < lines; ++row) {
+        const std::string empty;
+        const std::string& next = row < frame.size() ? frame[row] : empty;
+        const std::string& prev = row < previousFrame.size() ? previousFrame[row] : empty;
+        if (next == prev) continue;
+
+        size_t width = std::max(next.size(), prev.size());
+        size_t first = 0;
+        while (first < width && first < next.size() && first < prev.size() && next[first] == prev[first]) ++first;
+        size_t last = width;
+        while (last > first && last <= next.size() && last <= prev.size() && next[last - 1] == prev[last - 1]) --last;
+
+        out += "\033[" + std::to_string(row + 1) + ";" + std::to_string(first + 1) + "H";
+        std::string span = next.substr(std::min(first, next.size()), last - first);
+        span.resize(last - first, ' '); // blank out what the previous, longer line left behind
+        out += span;
+    }
+
+    std::cout << out << std::flush;
+    previousFrame = frame;
+}
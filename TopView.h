@@ -0,0 +1,40 @@
+#pragma once
+#include "Scheduler.h"
+#include "Process.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <unordered_map>
+
+/*
+    Live dashboard for the `top` command: utilization, queue lengths, what every core
+    is running and how fast, and the busiest processes, refreshed until a key is pressed.
+
+    Everything is read from the scheduler's lock-free counters and the processes'
+    published snapshots; rates are differences between two refreshes. The frame is
+    built as plain text lines and only the span of each line that differs from the
+    previous frame is rewritten, so a refresh with little change costs a few bytes.
+*/
+class TopView {
+public:
+    TopView(Scheduler& scheduler, unsigned long long refreshInterval = 500);
+
+    void run(); // returns when a key is pressed
+
+private:
+    static constexpr int CORES_PER_ROW = 4;
+    static constexpr size_t BUSIEST_SHOWN = 10;
+
+    Scheduler& scheduler;
+    unsigned long long refreshInterval;
+
+    std::vector<std::string> previousFrame;
+    std::vector<unsigned long long> previousCoreCounts;
+    std::unordered_map<int, unsigned long long> previousCompleted; // by PID, running processes only
+    std::chrono::steady_clock::time_point previousTime;
+
+    std::vector<std::string> buildFrame();
+    void draw(const std::vector<std::string>& frame);
+};
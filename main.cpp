@@ -1,577 +1,1194 @@
-/* Header Files */
-#include "Console.h"
-#include "ConsolePanel.h"
-#include "Process.h"
-#include "Config.h"
-#include "Scheduler.h"
-#include "InstructionUtils.h"
-#include "FCFSScheduler.h"
-#include "RRScheduler.h"
-
-/* Libraries */
-#include <string>
-#include <iostream>
-#include <random>
-#include <windows.h>
-#include <vector>
-#include <ctime>
-#include <cstdlib>
-#include <sstream>
-#include <iomanip>
-#include <unordered_set>
-#include <filesystem>
-#include <fstream>
-#include <chrono>
-
-#define ORANGE "\033[38;5;208m"
-#define RESET  "\033[0m"
-
-using namespace std;
-
-// function declarations
-void handleMainScreenCommands(const string& cmd, const vector<string>& args, ConsolePanel& consolePanel, vector<shared_ptr<Process>>& processList, 
-                              bool& hasInitialized, bool& notShuttingDown);
-void handleProcessScreenCommands(const string& cmd, const string& currentScreenName, const vector<shared_ptr<Process>>& processList, ConsolePanel& consolePanel);
-void setColor(unsigned char color);
-void header();
-pair<string, vector<string>> parseCommand(const string& input);
-void initialize();
-void scheduler_start(std::vector<std::shared_ptr<Process>>& processList, ConsolePanel& consolePanel);
-void scheduler_stop();
-void report_util(const std::vector<std::shared_ptr<Process>>& allProcesses, const std::vector<std::shared_ptr<Process>>& runningProcesses);
-void printSystemSummary();
-void printHelpMenu();
-void handleExit();
-void clear();
-void clearToProcessScreen();
-void displayProcessScreen(const std::shared_ptr<Process>& proc);
-void printLastUpdated();
-void startBatchGeneration(std::vector<std::shared_ptr<Process>>&, ConsolePanel&);
-void stopBatchGeneration();
-
-std::unique_ptr<Scheduler> scheduler;
-Config config;
-
-std::atomic<bool> isBatchGenerating = false;
-std::thread batchGeneratorThread;
-std::atomic<int> batchProcessCount = 0;
-int processCounter = 1;
-
-
-int main() {
-    srand(static_cast<unsigned>(time(nullptr)));
-
-    string input;
-    ConsolePanel consolePanel;
-    bool notShuttingDown = true;
-    bool hasInitialized = false;
-    vector<shared_ptr<Process>> processList;
-
-    header();
-
-    while (notShuttingDown) {
-        cout << "root:\\> ";
-        getline(cin, input);
-
-        auto [cmd, args] = parseCommand(input);
-
-        string currentScreen = consolePanel.getCurrentScreenName();
-
-        if (cmd != "initialize" && cmd != "exit" && !hasInitialized) {
-            cout << "Initialize the program with command \"initialize\" first!\n\n";
-            continue;
-        }
-
-        if (currentScreen == "MAIN_SCREEN") {
-            handleMainScreenCommands(cmd, args, consolePanel, processList, hasInitialized, notShuttingDown);
-        } else {
-            handleProcessScreenCommands(cmd, currentScreen, processList, consolePanel);
-        }
-    }
-    return 0;
-}
-
-void handleMainScreenCommands(const string& cmd, const vector<string>& args, ConsolePanel& consolePanel,
-                              vector<shared_ptr<Process>>& processList, bool& hasInitialized, bool& notShuttingDown) {
-    auto screens = consolePanel.getConsolePanels();
-
-    if (cmd == "exit") {
-        notShuttingDown = false;
-
-        if(scheduler != nullptr)
-            scheduler->stop();
-        
-        handleExit();
-    } 
-    
-    else if (cmd == "initialize") {
-        if (hasInitialized) {
-            cout << "System has already been initialized.\n\n";
-        } else {
-            hasInitialized = true;
-            initialize();
-
-        }
-    } 
-    
-    else if (cmd == "clear") {
-        clear();
-    } 
-    
-    else if (cmd == "help") {
-        printHelpMenu();
-    } 
-    
-    else if (cmd == "scheduler-start") {
-        scheduler_start(processList, consolePanel);
-    } 
-    
-    else if (cmd == "scheduler-stop") {
-        scheduler_stop();
-    } 
-    
-    else if (cmd == "report-util") {
-        report_util(processList, scheduler->getRunningProcesses());
-    } 
-    
-    else if (cmd == "screen" && args.size() == 1 && args[0] == "-ls") {
-        printSystemSummary();
-        consolePanel.listProcesses(processList, scheduler->getRunningProcesses());
-    } 
-    
-    else if (cmd == "screen" && args.size() >= 2 && args[0] == "-s") {
-        string procName = args[1];
-
-        for (const auto& c : screens) {
-            if (c->getConsoleName() == procName) {
-                cout << "Process '" << procName << "' already exists. Use -r to resume.\n\n";
-                return;
-            }
-        }
-
-        unsigned long long total = config.minInstructions + rand() % (config.maxInstructions - config.minInstructions + 1);
-
-        clearToProcessScreen();
-        auto newProc = make_shared<Process>(procName, total);
-
-        auto instructions = generateRandomInstructions(total);
-        for (const auto& instr : instructions) {
-            newProc->addInstruction(instr);
-        }
-
-        processList.push_back(newProc);
-
-        auto procConsole = make_shared<Console>(procName, 0, total, newProc->getProcessNo());
-        consolePanel.addConsolePanel(procConsole);
-        consolePanel.setCurrentScreen(procConsole);
-
-        displayProcessScreen(newProc);
-
-        scheduler->addProcess(newProc);
-
-    } 
-    
-    else if (cmd == "screen" && args.size() >= 2 && args[0] == "-r") {
-        string procName = args[1];
-        bool foundScreen = false, foundProcess = false;
-        std::shared_ptr<Process> targetProcess = nullptr;
-        std::shared_ptr<Console> currentPanel = nullptr;
-
-        for (auto& s : screens) {
-            if (s->getConsoleName() == procName) {
-                foundScreen = true;
-                currentPanel = s;
-                break;
-            }
-        }
-
-        for (auto& p : processList) {
-            if (p->getProcessName() == procName) {
-                foundProcess = true;
-                targetProcess = p;
-                break;
-            }
-        }
-
-        if (!foundScreen || !foundProcess || targetProcess->isFinished()) {
-            cout << "Process '" << procName << "' not found.\n\n";
-            return;
-        }
-
-        clearToProcessScreen();
-        consolePanel.setCurrentScreen(currentPanel);
-        displayProcessScreen(targetProcess);
-
-    } 
-    
-    else {
-        cout << "Unknown command! Type \"help\" for commandlist.\n\n";
-    }
-}
-
-void handleProcessScreenCommands(const string& cmd, const string& currentScreenName, const vector<shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
-    auto screens = consolePanel.getConsolePanels();
-    
-    if (cmd == "exit") {
-        cout << "\033c" << flush;
-        for (auto& screenPtr : screens) {
-                if (screenPtr->getConsoleName() == "MAIN_SCREEN") {
-                    consolePanel.setCurrentScreen(screenPtr);
-                    break;
-                }
-            }
-            if (consolePanel.getCurrentScreenName() == "MAIN_SCREEN") {
-                clear();
-            }
-    } 
-    
-    else if (cmd == "process-smi") {
-        for (auto& p : processList) {
-            if (p->getProcessName() == currentScreenName) {
-                displayProcessScreen(p);
-                break;
-            }
-        }
-    } 
-    
-    else {
-        cout << "Only 'exit' and 'process-smi' commands are allowed inside a process screen.\n\n";
-    }
-}
-
-void displayProcessScreen(const std::shared_ptr<Process>& proc) {
-    std::string logsDir = "processLogs";
-    std::string logFilePath = logsDir + "/" + proc->getProcessName() + ".txt";
-
-    cout << "\n=====================================================\n";
-    setColor(0x02); //color green
-    cout << "                  PROCESS CONSOLE SCREEN             \n";
-    setColor(0x07); // default
-    cout << "=====================================================\n";
-    cout << "Process name: " << proc->getProcessName() << "\n";
-    cout << "ID: " << ORANGE << proc->getProcessNo() << RESET << "\n";
-    cout << "Logs:\n\n";
-
-    // print each instruction logs
-    const auto& logs = proc->getLogLines();
-
-    for (const auto& line : logs) {
-        std::cout << line;
-    }
-
-    std::cout << "\n";
-
-    // Progress / Completion message
-    if (proc->isFinished()) {
-        std::cout << ORANGE << "Finished!" << RESET << "\n";
-    } else {
-        std::cout << "Current instruction line: " << ORANGE << proc->getCompletedCommands() << RESET << "\n";
-        std::cout << "Lines of instruction: " << ORANGE << proc->getTotalNoOfCommands() << RESET << "\n";
-    }
-
-    std::cout << "=====================================================\n";
-}
-
-void setColor( unsigned char color ){
-	SetConsoleTextAttribute( GetStdHandle( STD_OUTPUT_HANDLE ), color );
-}
-
-void printLastUpdated() {
-    namespace fs = std::filesystem;
-
-    std::string path = (fs::current_path() / "main.cpp").string();
-
-    //std::cout << "Current path: " << path << "\n";
-
-    try
-    {
-        auto ftime = fs::last_write_time(path);
-
-        auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-            ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now()
-        );
-
-        std::time_t cftime = std::chrono::system_clock::to_time_t(sctp);
-
-        std::cout << "Last updated: " 
-                  << std::put_time(std::localtime(&cftime), "%m/%d/%Y %I:%M:%S %p") 
-                  << std::endl;
-    }
-    catch (const fs::filesystem_error& e)
-    {
-        std::cerr << "Error: " << e.what() << std::endl;
-    }
-}
-
-void header() {
-    setColor(0x07);
-    cout << "  ____ ____  ____  _____ _____ ____ __   __     " << endl;
-    cout << " / __/  ___|/ __ `|  _  ` ____/ ___`  ` / /     " << endl;
-    cout << "| |   `___ ` |  | | |_| |  __|`___ ` `   /      " << endl;
-    cout << "| |__ ___) | |__| | ___/| |___ ___) | | |       " << endl;
-    cout << " `___` ____/`____/|_|   |_____|___ /  |_|       " << endl;
-    cout << "--------------------------------------------------\n";
-    setColor(0x02);
-    cout << "Hello, Welcome to CSOPESY commandline!\n\n";
-
-    setColor(0x07);
-    cout << "Developers:\n";
-    cout << "Albarracin, Clarissa\n";
-    cout << "Garcia, Reina Althea\n";
-    cout << "Santos, Miko\n\n";
-
-    printLastUpdated();
-    cout << "\n\n";
-
-    setColor(0x0E);
-    cout << "Type 'exit' to quit, 'clear' to clear the screen\n"; 
-    cout << "--------------------------------------------------\n";
-    setColor(0x07);
-}
-
-pair<string, vector<string>> parseCommand(const string& input) {
-	istringstream stream(input);
-	string cmd;
-	stream >> cmd;
-
-	vector<string> args;
-	string arg;
-	
-	while (stream >> arg) {
-		args.push_back(arg);
-	}
-
-	return {cmd, args};
-}
-
-void initialize() {
-    // delete any existing previous logs
-    std::string consoleLogFile = "csopesy-log.txt";
-
-    try {
-        bool isDeleted = false;
-        
-        // Delete console-log.txt if it exists
-        if (std::filesystem::exists(consoleLogFile)) {
-            std::filesystem::remove(consoleLogFile);
-            isDeleted = true;
-        }
-        
-        if (isDeleted) {
-            std::cout << "Deleted previous log files.\n\n";
-        }
-        
-    } catch (const std::filesystem::filesystem_error& e) {
-        std::cerr << "Error deleting files: " << e.what() << std::endl;
-    }
-
-
-    config = loadConfig("config.txt");
-
-    std::cout << ORANGE << "[Initializing System...]\n" << RESET;
-
-    std::cout << "Loaded configuration:\n";
-    std::cout << "  Scheduler type     : " << ORANGE << config.schedulerType    << RESET << "\n";
-    std::cout << "  Number of CPUs     : " << ORANGE << config.numCPUs          << RESET << "\n";
-    std::cout << "  Quantum cycles     : " << ORANGE << config.quantumCycles    << RESET << "\n";
-    std::cout << "  Batch process freq : " << ORANGE << config.batchProcessFreq << RESET << "\n";
-    std::cout << "  Min instructions   : " << ORANGE << config.minInstructions  << RESET << "\n";
-    std::cout << "  Max instructions   : " << ORANGE << config.maxInstructions  << RESET << "\n";
-    std::cout << "  Delay per exec     : " << ORANGE << config.delaysPerExec    << RESET << "\n";
-
-    std::cout << "\nStarting scheduler...\n";
-
-    if (config.schedulerType == "fcfs") {
-        scheduler = std::make_unique<FCFSScheduler>(config.numCPUs, config.delaysPerExec);
-        scheduler->start();
-        std::cout << ORANGE << "[FCFS Scheduler started with "
-                  << config.numCPUs << " cores]" << RESET << "\n\n";
-    } 
-    
-    else if (config.schedulerType == "rr") {
-        scheduler = std::make_unique<RRScheduler>(config.numCPUs, config.delaysPerExec, config.quantumCycles);
-        scheduler->start();
-        std::cout << ORANGE << "[RR Scheduler started with "
-                  << config.numCPUs << " cores]" << RESET << "\n\n";
-    } 
-    
-    else {
-        std::cout << "Invalid scheduler type in config file.\n\n";
-        return;
-    }
-}
-
-void scheduler_start(std::vector<std::shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
-	startBatchGeneration(processList, consolePanel);
-}
-
-void scheduler_stop() {
-	stopBatchGeneration();
-}
-
-void report_util(const std::vector<std::shared_ptr<Process>>& allProcesses,
-                const std::vector<std::shared_ptr<Process>>& runningProcesses) {
-
-    std::filesystem::path logPath = std::filesystem::current_path() / "csopesy-log.txt";
-    std::ofstream log("csopesy-log.txt");
-    if (!log.is_open()) {
-        std::cerr << "Failed to open csopesy-log.txt for writing.\n";
-        return;
-    }
-
-    int busy = scheduler->getBusyCoreCount();
-    int total = scheduler->getAvailableCoreCount() + busy;
-    int utilization = (static_cast<double>(busy) / total) * 100;
-
-    log << "========== System Summary ============\n";
-    if (scheduler) {
-        log << "CPU Utilization: " << utilization << "%\n";
-        log << "Cores Used: " << scheduler->getBusyCoreCount() << "\n";
-        log << "Cores available: " << scheduler->getAvailableCoreCount() << "\n";
-    } else {
-        log << "Scheduler not running.\n";
-    }
-    log << "======================================\n";
-
-    // Running processes
-    std::unordered_set<std::shared_ptr<Process>> runningSet(runningProcesses.begin(), runningProcesses.end());
-
-    log << "Running Processes:\n";
-    for (const auto& proc : runningProcesses) {
-        auto snapshot = proc->getAtomicSnapshot();
-        if (snapshot.processName == "MAIN_SCREEN") continue;
-
-        log << std::left << std::setw(15) << snapshot.processName
-                  << snapshot.time << "   "
-                  << "Core: " << snapshot.coreNo <<  "   "
-                  << snapshot.completedCommands
-                  << " / "
-                  << snapshot.totalNoCommands
-                  << "\n";
-    }
-
-    log << "\nFinished Processes:\n";
-    for (const auto& proc : allProcesses) {
-        if (proc->getProcessName() == "MAIN_SCREEN") continue;
-
-        if (proc->isFinished() && !runningSet.count(proc)) {
-            log << proc->getProcessName() << "\t\t"
-                      << proc->getRawTime()                            << "   "
-                      << "Finished!"                                << "   "
-                      << proc->getCompletedCommands() << " / "
-                      << proc->getTotalNoOfCommands() 
-                      << "\n";
-        }
-    }
-
-    log << "======================================\n\n";
-
-    log.close();
-    setColor(0x02); //color green
-    cout << "Report generated at: " << logPath << "!\n\n";
-    setColor(0x07); //default
-}
-
-void printSystemSummary() {
-    int busy = scheduler->getBusyCoreCount();
-    int total = scheduler->getAvailableCoreCount() + busy;
-    int utilization = (static_cast<double>(busy) / total) * 100;
-
-    cout << "========== System Summary ============\n";
-    cout << "CPU Utilization: "    << utilization << "%\n";
-    cout << "Cores Used: "         << scheduler->getBusyCoreCount() << "\n";
-    cout << "Cores available: "    << scheduler->getAvailableCoreCount() << "\n";
-    cout << "======================================\n";
-}
-
-void printHelpMenu() {
-    cout << "  initialize        - Initialize system\n";
-    cout << "  screen -s <name>  - Start new screen\n";
-    cout << "  screen -r <name>  - Resume existing screen\n";
-    cout << "  scheduler-start   - Run scheduler start\n";
-    cout << "  scheduler-stop    - Stop scheduler\n";
-    cout << "  report-util       - Display utilization report\n";
-    cout << "  clear             - Clear the screen\n";
-    cout << "  screen -ls        - List all screen processes\n";
-    cout << "  help              - Show this help menu\n";
-    cout << "  exit              - Exit the program\n\n";
-}
-
-void handleExit() {
-    exit(0);
-}
-
-void clear() {
-	cout << "\033c" << flush;
-	header();
-}
-
-void clearToProcessScreen() {
-	cout << "\033c" << flush;
-}
-
-void startBatchGeneration(std::vector<std::shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
-    if (isBatchGenerating) {
-        std::cout << "Batch generation already running!\n\n";
-        return;
-    }
-
-    isBatchGenerating = true;
-
-    batchGeneratorThread = std::thread([&processList, &consolePanel]() {
-        int localTicks = 0;
-
-        while (isBatchGenerating) {
-            // std::this_thread::sleep_for(std::chrono::milliseconds(1)); // 1 tick = 1 ms
-            localTicks++;
-
-            if (localTicks  >= config.batchProcessFreq) {
-                localTicks = 0;
-
-                // Generate process name
-                std::ostringstream ss;
-                ss << "p" << std::setw(2) << std::setfill('0') << processCounter++;
-                std::string procName = ss.str();
-
-                // Random instruction count
-                unsigned long long total = config.minInstructions + rand() % (config.maxInstructions - config.minInstructions + 1);
-                auto newProc = std::make_shared<Process>(procName, total);
-
-                // Generate random instructions
-                auto instructions = generateRandomInstructions(total);
-                for (const auto& instr : instructions)
-                    newProc->addInstruction(instr);
-
-                processList.push_back(newProc);
-                
-                // Create console screen
-                int dummyCurr = rand() % 100;
-                auto procConsole = std::make_shared<Console>(procName, dummyCurr, total, newProc->getProcessNo());
-                consolePanel.addConsolePanel(procConsole);
-
-                scheduler->addProcess(newProc);
-                batchProcessCount++;
-            }
-            
-            // check frequently even if batchProcessFreq is high
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
-    });
-
-    std::cout << "Started batch process generation.\n\n";
-}
-
-void stopBatchGeneration() {
-    if (!isBatchGenerating) {
-        std::cout << "No batch generation is running.\n\n";
-        return;
-    }
-
-    isBatchGenerating = false;
-
-    if (batchGeneratorThread.joinable())
-        batchGeneratorThread.join();
-
-    std::cout << "Stopped batch process generation.\n";
-    std::cout << "Total processes generated: " << batchProcessCount << "\n\n";
-}
+/* Header Files */
+#include "Console.h"
+#include "ConsolePanel.h"
+#include "Process.h"
+#include "Config.h"
+#include "Scheduler.h"
+#include "InstructionUtils.h"
+#include "FCFSScheduler.h"
+#include "RRScheduler.h"
+#include "MLFQScheduler.h"
+#include "SJFScheduler.h"
+#include "CFSScheduler.h"
+#include "DomainScheduler.h"
+#include "ProcessLogSink.h"
+#include "SchedulerTrace.h"
+#include "TopView.h"
+#include "Checkpoint.h"
+#include "AdmissionControl.h"
+#include "ProcessArchive.h"
+#include "CpuAffinity.h"
+#include "SchedulerCompare.h"
+
+/* Libraries */
+#include <string>
+#include <iostream>
+#include <random>
+#include <windows.h>
+#include <vector>
+#include <ctime>
+#include <cstdlib>
+#include <sstream>
+#include <iomanip>
+#include <unordered_set>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+
+#define ORANGE "\033[38;5;208m"
+#define RESET  "\033[0m"
+
+using namespace std;
+
+// function declarations
+void handleMainScreenCommands(const string& cmd, const vector<string>& args, ConsolePanel& consolePanel, vector<shared_ptr<Process>>& processList, 
+                              bool& hasInitialized, bool& notShuttingDown);
+void handleProcessScreenCommands(const string& cmd, const string& currentScreenName, const vector<shared_ptr<Process>>& processList, ConsolePanel& consolePanel);
+void setColor(unsigned char color);
+void header();
+pair<string, vector<string>> parseCommand(const string& input);
+void initialize();
+bool buildScheduler();
+void applyCpuAffinity(const CpuAffinity& affinity);
+std::unique_ptr<Scheduler> makeScheduler(const Config& settings, CpuAffinity& affinity);
+void startScheduler(std::unique_ptr<Scheduler> built, const CpuAffinity& affinity);
+std::unique_ptr<Scheduler> createScheduler(int cores, const std::string& type, const Config& settings);
+void scheduler_start(std::vector<std::shared_ptr<Process>>& processList, ConsolePanel& consolePanel);
+void scheduler_stop();
+void report_util(const std::vector<std::shared_ptr<Process>>& allProcesses, const std::vector<std::shared_ptr<Process>>& runningProcesses);
+void printSystemSummary();
+void printUtilization(std::ostream& out, bool perCore);
+void printHelpMenu();
+void handleExit();
+void clear();
+void clearToProcessScreen();
+void displayProcessScreen(const std::shared_ptr<Process>& proc);
+void traceCommand(const vector<string>& args);
+void coresCommand(const vector<string>& args);
+void checkpointCommand(const vector<string>& args, const vector<shared_ptr<Process>>& processList);
+void restoreCommand(const vector<string>& args, vector<shared_ptr<Process>>& processList, ConsolePanel& consolePanel);
+void compareCommand(const vector<string>& args);
+void printLastUpdated();
+void startBatchGeneration(std::vector<std::shared_ptr<Process>>&, ConsolePanel&);
+void stopBatchGeneration();
+void startReaper(std::vector<std::shared_ptr<Process>>& processList);
+void stopReaper();
+
+std::unique_ptr<Scheduler> scheduler;
+std::unique_ptr<ProcessLogSink> logSink;
+std::unique_ptr<SchedulerTrace> schedulerTrace; // created by the first trace start, reused after
+Config config;
+
+std::atomic<bool> isBatchGenerating = false;
+std::thread batchGeneratorThread;
+std::atomic<int> batchProcessCount = 0;
+std::unique_ptr<AdmissionControl> admission; // of the current (or last) batch generation
+int generatorCpu = -1; // host CPU the batch generator pins itself to (cpu-affinity)
+
+// processList is appended to by the batch generator and pruned by the reaper
+std::mutex processListMutex;
+ProcessArchive archive;
+std::atomic<bool> isReaping = false;
+std::thread reaperThread;
+int processCounter = 1;
+
+
+int main() {
+    srand(static_cast<unsigned>(time(nullptr)));
+
+    string input;
+    ConsolePanel consolePanel;
+    bool notShuttingDown = true;
+    bool hasInitialized = false;
+    vector<shared_ptr<Process>> processList;
+
+    header();
+
+    while (notShuttingDown) {
+        cout << "root:\\> ";
+        getline(cin, input);
+
+        auto [cmd, args] = parseCommand(input);
+
+        string currentScreen = consolePanel.getCurrentScreenName();
+
+        if (cmd != "initialize" && cmd != "exit" && !hasInitialized) {
+            cout << "Initialize the program with command \"initialize\" first!\n\n";
+            continue;
+        }
+
+        if (currentScreen == "MAIN_SCREEN") {
+            handleMainScreenCommands(cmd, args, consolePanel, processList, hasInitialized, notShuttingDown);
+        } else {
+            handleProcessScreenCommands(cmd, currentScreen, processList, consolePanel);
+        }
+    }
+    return 0;
+}
+
+void handleMainScreenCommands(const string& cmd, const vector<string>& args, ConsolePanel& consolePanel,
+                              vector<shared_ptr<Process>>& processList, bool& hasInitialized, bool& notShuttingDown) {
+    auto screens = consolePanel.getConsolePanels();
+
+    if (cmd == "exit") {
+        notShuttingDown = false;
+
+        stopReaper();
+        if(scheduler != nullptr)
+            scheduler->stop();
+
+        // flush whatever the cores logged last
+        if (logSink != nullptr) {
+            Process::setLogSink(nullptr);
+            logSink->stop();
+        }
+        
+        handleExit();
+    } 
+    
+    else if (cmd == "initialize") {
+        if (hasInitialized) {
+            cout << "System has already been initialized.\n\n";
+        } else {
+            hasInitialized = true;
+            initialize();
+            startReaper(processList);
+
+        }
+    } 
+    
+    else if (cmd == "clear") {
+        clear();
+    } 
+    
+    else if (cmd == "help") {
+        printHelpMenu();
+    } 
+    
+    else if (cmd == "scheduler-start") {
+        scheduler_start(processList, consolePanel);
+    } 
+    
+    else if (cmd == "scheduler-stop") {
+        scheduler_stop();
+    } 
+    
+    else if (cmd == "report-util") {
+        std::lock_guard<std::mutex> lock(processListMutex);
+        report_util(processList, scheduler->getRunningProcesses());
+    } 
+    
+    else if (cmd == "screen" && args.size() == 1 && args[0] == "-ls") {
+        printSystemSummary();
+        std::lock_guard<std::mutex> lock(processListMutex);
+        consolePanel.listProcesses(processList, scheduler->getRunningProcesses(), archive);
+    } 
+    
+    else if (cmd == "screen" && args.size() >= 2 && args[0] == "-s") {
+        string procName = args[1];
+
+        for (const auto& c : screens) {
+            if (c->getConsoleName() == procName) {
+                cout << "Process '" << procName << "' already exists. Use -r to resume.\n\n";
+                return;
+            }
+        }
+
+        unsigned long long total = config.minInstructions + rand() % (config.maxInstructions - config.minInstructions + 1);
+
+        clearToProcessScreen();
+        auto newProc = make_shared<Process>(procName, total);
+
+        // optional nice value, only used by the CFS scheduler
+        if (args.size() >= 3) {
+            try {
+                newProc->setNice(std::stoi(args[2]));
+            } catch (const std::exception&) {
+                cout << "Invalid nice value '" << args[2] << "', using 0.\n";
+            }
+        }
+
+        newProc->setProgram(ProgramImage::create(generateRandomInstructions(total)));
+
+        {
+            std::lock_guard<std::mutex> lock(processListMutex);
+            processList.push_back(newProc);
+        }
+
+        auto procConsole = make_shared<Console>(procName, 0, total, newProc->getProcessNo());
+        consolePanel.addConsolePanel(procConsole);
+        consolePanel.setCurrentScreen(procConsole);
+
+        displayProcessScreen(newProc);
+
+        scheduler->addProcess(newProc);
+
+    } 
+    
+    else if (cmd == "screen" && args.size() >= 2 && args[0] == "-r") {
+        string procName = args[1];
+        bool foundScreen = false, foundProcess = false;
+        std::shared_ptr<Process> targetProcess = nullptr;
+        std::shared_ptr<Console> currentPanel = nullptr;
+
+        for (auto& s : screens) {
+            if (s->getConsoleName() == procName) {
+                foundScreen = true;
+                currentPanel = s;
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(processListMutex);
+            for (auto& p : processList) {
+                if (p->getProcessName() == procName) {
+                    foundProcess = true;
+                    targetProcess = p;
+                    break;
+                }
+            }
+        }
+
+        if (!foundScreen || !foundProcess || targetProcess->isFinished()) {
+            cout << "Process '" << procName << "' not found.\n\n";
+            return;
+        }
+
+        clearToProcessScreen();
+        consolePanel.setCurrentScreen(currentPanel);
+        displayProcessScreen(targetProcess);
+
+    } 
+
+    else if (cmd == "trace") {
+        traceCommand(args);
+    } 
+
+    else if (cmd == "cores") {
+        coresCommand(args);
+    } 
+
+    else if (cmd == "top") {
+        TopView(*scheduler).run();
+        clear();
+    } 
+
+    else if (cmd == "compare") {
+        compareCommand(args);
+    } 
+
+    else if (cmd == "checkpoint") {
+        checkpointCommand(args, processList);
+    } 
+
+    else if (cmd == "restore") {
+        restoreCommand(args, processList, consolePanel);
+    } 
+    
+    else {
+        cout << "Unknown command! Type \"help\" for commandlist.\n\n";
+    }
+}
+
+void handleProcessScreenCommands(const string& cmd, const string& currentScreenName, const vector<shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
+    auto screens = consolePanel.getConsolePanels();
+    
+    if (cmd == "exit") {
+        cout << "\033c" << flush;
+        for (auto& screenPtr : screens) {
+                if (screenPtr->getConsoleName() == "MAIN_SCREEN") {
+                    consolePanel.setCurrentScreen(screenPtr);
+                    break;
+                }
+            }
+            if (consolePanel.getCurrentScreenName() == "MAIN_SCREEN") {
+                clear();
+            }
+    } 
+    
+    else if (cmd == "process-smi") {
+        std::shared_ptr<Process> target;
+        {
+            std::lock_guard<std::mutex> lock(processListMutex);
+            for (auto& p : processList) {
+                if (p->getProcessName() == currentScreenName) {
+                    target = p;
+                    break;
+                }
+            }
+        }
+        if (target) displayProcessScreen(target);
+    } 
+    
+    else {
+        cout << "Only 'exit' and 'process-smi' commands are allowed inside a process screen.\n\n";
+    }
+}
+
+void displayProcessScreen(const std::shared_ptr<Process>& proc) {
+    cout << "\n=====================================================\n";
+    setColor(0x02); //color green
+    cout << "                  PROCESS CONSOLE SCREEN             \n";
+    setColor(0x07); // default
+    cout << "=====================================================\n";
+    cout << "Process name: " << proc->getProcessName() << "\n";
+    cout << "ID: " << ORANGE << proc->getProcessNo() << RESET << "\n";
+    cout << "Logs:\n\n";
+
+    // print each instruction logs
+    const auto& logs = proc->getLogLines();
+
+    for (const auto& line : logs) {
+        std::cout << line;
+    }
+
+    std::cout << "\n";
+
+    // Progress / Completion message
+    if (proc->isFinished()) {
+        std::cout << ORANGE << "Finished!" << RESET << "\n";
+    } else {
+        std::cout << "Current instruction line: " << ORANGE << proc->getCompletedCommands() << RESET << "\n";
+        std::cout << "Lines of instruction: " << ORANGE << proc->getTotalNoOfCommands() << RESET << "\n";
+    }
+    std::cout << "Core migrations: " << ORANGE << proc->getMigrations() << RESET << "\n";
+    if (logSink) {
+        std::cout << "Log file: " << logSink->getLogFilePath(proc->getProcessName()) << "\n";
+    }
+
+    std::cout << "=====================================================\n";
+}
+
+// cores | cores add <n> | cores remove <n>
+void coresCommand(const vector<string>& args) {
+    if (!args.empty()) {
+        int count = 0;
+        try {
+            if (args.size() >= 2) count = std::stoi(args[1]);
+        } catch (const std::exception&) {}
+
+        if ((args[0] != "add" && args[0] != "remove") || count <= 0) {
+            cout << "Usage: cores add <n> | cores remove <n>\n\n";
+            return;
+        }
+
+        int changed = args[0] == "add" ? scheduler->addCores(count) : scheduler->removeCores(count);
+        if (changed == 0 && config.schedDomains > 1) {
+            cout << "Cores cannot be resized with scheduling domains.\n";
+        } else if (changed == 0 && args[0] == "add") {
+            cout << "Already at the maximum of " << scheduler->getCoreCapacity() << " cores (max-cpu).\n";
+        } else {
+            cout << (args[0] == "add" ? "Added " : "Removed ") << changed << " core(s).\n";
+        }
+    }
+
+    cout << ORANGE << "[" << scheduler->getCoreCount() << " cores active, up to "
+         << scheduler->getCoreCapacity() << "]" << RESET << "\n\n";
+}
+
+// checkpoint <file>
+void checkpointCommand(const vector<string>& args, const vector<shared_ptr<Process>>& processList) {
+    if (args.empty()) {
+        cout << "Usage: checkpoint <file>\n\n";
+        return;
+    }
+
+    /*
+        One consistent snapshot: the process list (so the reaper and new processes wait)
+        and the scheduler's ready and sleep queues stay locked while every process is
+        encoded, so no queued process is dispatched and no sleeper woken in between.
+        Processes on a core keep running and are saved under their own lock; restore puts
+        them back in the ready queue, or to sleep if their burst had just stopped on SLEEP.
+    */
+    auto started = std::chrono::steady_clock::now();
+    Checkpoint checkpoint;
+    checkpoint.config = config;
+    checkpoint.processCounter = processCounter;
+    checkpoint.nextProcessNum = Process::getNextProcessNum();
+    std::string encoded;
+    {
+        std::lock_guard<std::mutex> lock(processListMutex);
+        checkpoint.processes = processList;
+        archive.forEach([&](const ProcessRecord& record) { checkpoint.archived.push_back(record); });
+        scheduler->captureQueues([&](const Scheduler::ReadyList& ready, const Scheduler::SleepingList& sleeping) {
+            checkpoint.readyOrder = ready;
+            checkpoint.sleeping = sleeping;
+            encoded = encodeCheckpoint(checkpoint);
+        });
+    }
+
+    std::string error;
+    if (!saveCheckpoint(args[0], encoded, error)) {
+        cout << "Could not save checkpoint: " << error << "\n\n";
+        return;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+
+    std::error_code ec;
+    auto size = std::filesystem::file_size(args[0], ec);
+    setColor(0x02); //color green
+    cout << "Checkpoint saved at: " << args[0] << " (" << checkpoint.processes.size() << " processes, "
+         << (ec ? 0 : size) << " bytes, " << elapsed.count() << " ms)!\n\n";
+    setColor(0x07); //default
+}
+
+/*
+    restore <file>
+    Replaces the running system with the checkpoint: the scheduler is rebuilt from the saved
+    config, queued processes go back in their saved order (the ones that were on a core
+    first), SLEEPing ones sleep out the ticks they had left. Refused while batch generation
+    runs; the reaper is paused across the swap since it reads the config.
+*/
+void restoreCommand(const vector<string>& args, vector<shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
+    if (args.empty()) {
+        cout << "Usage: restore <file>\n\n";
+        return;
+    }
+
+    if (isBatchGenerating) {
+        cout << "Stop batch generation (scheduler-stop) before restoring.\n\n";
+        return;
+    }
+
+    Checkpoint checkpoint;
+    std::string error;
+    if (!loadCheckpoint(args[0], checkpoint, error)) {
+        cout << "Could not restore " << args[0] << ": " << error << "\n\n";
+        return;
+    }
+
+    // built before anything is torn down, so a checkpoint with an unusable config leaves
+    // the running system as it was
+    CpuAffinity affinity;
+    auto restored = makeScheduler(checkpoint.config, affinity);
+    if (!restored) {
+        cout << "Could not restore " << args[0] << ": its configuration is invalid.\n\n";
+        return;
+    }
+
+    stopReaper();
+    scheduler->stop();
+    scheduler.reset();
+    if (logSink != nullptr) {
+        Process::setLogSink(nullptr);
+        logSink->stop();
+        logSink.reset();
+    }
+
+    config = checkpoint.config;
+    startScheduler(std::move(restored), affinity);
+
+    processCounter = static_cast<int>(checkpoint.processCounter);
+    Process::setNextProcessNum(checkpoint.nextProcessNum);
+    {
+        std::lock_guard<std::mutex> lock(processListMutex);
+        processList = checkpoint.processes;
+    }
+    archive.clear();
+    for (auto& record : checkpoint.archived) archive.append(std::move(record));
+    startReaper(processList);
+
+    auto screens = consolePanel.getConsolePanels();
+    std::unordered_set<std::string> screenNames;
+    for (const auto& s : screens) screenNames.insert(s->getConsoleName());
+    for (const auto& proc : processList) {
+        if (screenNames.insert(proc->getProcessName()).second) {
+            consolePanel.addConsolePanel(std::make_shared<Console>(proc->getProcessName(), 0,
+                                                                   proc->getTotalNoOfCommands(), proc->getProcessNo()));
+        }
+    }
+
+    std::unordered_set<Process*> placed;
+    for (const auto& proc : checkpoint.readyOrder) placed.insert(proc.get());
+    for (const auto& [proc, ticks] : checkpoint.sleeping) placed.insert(proc.get());
+
+    // finished processes stay out of both queues whatever list they were saved in
+    auto requeue = [&](const std::shared_ptr<Process>& proc) {
+        proc->setState(ProcessState::READY);
+        scheduler->adoptProcess(proc);
+    };
+    for (const auto& proc : processList) {
+        if (proc->isFinished() || placed.count(proc.get())) continue;
+        // was on a core: its burst may have stopped on a SLEEP not parked yet (a WAITING
+        // one in neither list had already been woken)
+        unsigned long long pendingSleep = proc->getPendingSleepTicks();
+        if (proc->getState() == ProcessState::RUNNING && pendingSleep > 0) scheduler->restoreSleeping(proc, pendingSleep);
+        else requeue(proc);
+    }
+    std::unordered_set<Process*> queued;
+    for (const auto& proc : checkpoint.readyOrder) {
+        if (!proc->isFinished() && queued.insert(proc.get()).second) requeue(proc);
+    }
+    for (const auto& [proc, ticks] : checkpoint.sleeping) {
+        if (!proc->isFinished() && !queued.count(proc.get())) scheduler->restoreSleeping(proc, ticks);
+    }
+
+    setColor(0x02); //color green
+    cout << "Restored " << processList.size() << " processes from " << args[0] << "!\n\n";
+    setColor(0x07); //default
+}
+
+/*
+    compare [processes] [scheduler ...]
+    Generates one workload (processes arriving batch-process-freq ms apart, programs as
+    the batch generator makes them) and runs it through every scheduler type, or the
+    listed ones, at once, each in its own engine with the configured cores and quanta.
+    Prints throughput, turnaround, waiting, context switches and utilization side by side.
+*/
+void compareCommand(const vector<string>& args) {
+    static const std::vector<std::string> ALL_SCHEDULERS = {"fcfs", "rr", "mlfq", "sjf", "srtf", "cfs"};
+    static constexpr size_t DEFAULT_PROCESSES = 50;
+
+    if (isBatchGenerating) {
+        cout << "Stop batch generation (scheduler-stop) before comparing.\n\n";
+        return;
+    }
+
+    size_t count = DEFAULT_PROCESSES;
+    std::vector<std::string> types;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (i == 0 && !args[i].empty() && std::all_of(args[i].begin(), args[i].end(), ::isdigit)) {
+            count = std::stoul(args[i]);
+        } else if (std::find(ALL_SCHEDULERS.begin(), ALL_SCHEDULERS.end(), args[i]) != ALL_SCHEDULERS.end()) {
+            types.push_back(args[i]);
+        } else {
+            cout << "Usage: compare [processes] [fcfs|rr|mlfq|sjf|srtf|cfs ...]\n\n";
+            return;
+        }
+    }
+    if (count == 0) count = DEFAULT_PROCESSES;
+    if (types.empty()) types = ALL_SCHEDULERS;
+
+    std::vector<CompareArrival> workload;
+    for (size_t i = 0; i < count; ++i) {
+        unsigned long long total = config.minInstructions + rand() % (config.maxInstructions - config.minInstructions + 1);
+        workload.push_back({i * config.batchProcessFreq, ProgramImage::create(generateRandomInstructions(total)), total});
+    }
+
+    cout << "Comparing " << count << " processes arriving every " << config.batchProcessFreq << " ms on "
+         << config.numCPUs << " cores (quantum " << config.quantumCycles << ", delay " << config.delaysPerExec << ")...\n";
+    auto started = std::chrono::steady_clock::now();
+
+    SchedulerCompare compare(std::move(workload), [](const std::string& type) {
+        return createScheduler(config.numCPUs, type, config);
+    });
+    auto results = compare.run(types);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    cout << "\n";
+    SchedulerCompare::printTable(cout, results);
+    cout << ORANGE << "[" << types.size() << " scheduler(s) compared in " << elapsed.count() << " ms]" << RESET << "\n\n";
+}
+
+// trace start | trace stop [file]
+void traceCommand(const vector<string>& args) {
+    if (args.empty() || (args[0] != "start" && args[0] != "stop")) {
+        cout << "Usage: trace start | trace stop [file]\n\n";
+        return;
+    }
+
+    if (args[0] == "start") {
+        if (schedulerTrace && schedulerTrace->isRunning()) {
+            cout << "Trace is already recording.\n\n";
+            return;
+        }
+        // never freed: a core may still hold the pointer after trace stop
+        if (!schedulerTrace) {
+            schedulerTrace = std::make_unique<SchedulerTrace>(scheduler->getCoreCapacity(), config.traceBuffer);
+            Scheduler::setTrace(schedulerTrace.get());
+        }
+        schedulerTrace->start();
+        cout << ORANGE << "[Trace started, " << config.traceBuffer << " events per core]" << RESET << "\n\n";
+        return;
+    }
+
+    if (!schedulerTrace || !schedulerTrace->isRunning()) {
+        cout << "No trace is recording. Use 'trace start' first.\n\n";
+        return;
+    }
+
+    std::string tracePath = args.size() >= 2 ? args[1] : "scheduler-trace.bin";
+    bool saved = schedulerTrace->stop(tracePath);
+    auto recorded = schedulerTrace->getRecordedCount();
+    auto dropped = schedulerTrace->getDroppedCount();
+
+    if (!saved) {
+        cout << "Could not write trace to " << tracePath << ".\n\n";
+        return;
+    }
+    setColor(0x02); //color green
+    cout << "Trace saved at: " << tracePath << " (" << recorded << " events, " << dropped << " dropped)!\n\n";
+    setColor(0x07); //default
+}
+
+void setColor( unsigned char color ){
+	SetConsoleTextAttribute( GetStdHandle( STD_OUTPUT_HANDLE ), color );
+}
+
+void printLastUpdated() {
+    namespace fs = std::filesystem;
+
+    std::string path = (fs::current_path() / "main.cpp").string();
+
+    //std::cout << "Current path: " << path << "\n";
+
+    try
+    {
+        auto ftime = fs::last_write_time(path);
+
+        auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+            ftime - fs::file_time_type::clock::now() + std::chrono::system_clock::now()
+        );
+
+        std::time_t cftime = std::chrono::system_clock::to_time_t(sctp);
+
+        std::cout << "Last updated: " 
+                  << std::put_time(std::localtime(&cftime), "%m/%d/%Y %I:%M:%S %p") 
+                  << std::endl;
+    }
+    catch (const fs::filesystem_error& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+}
+
+void header() {
+    setColor(0x07);
+    cout << "  ____ ____  ____  _____ _____ ____ __   __     " << endl;
+    cout << " / __/  ___|/ __ `|  _  ` ____/ ___`  ` / /     " << endl;
+    cout << "| |   `___ ` |  | | |_| |  __|`___ ` `   /      " << endl;
+    cout << "| |__ ___) | |__| | ___/| |___ ___) | | |       " << endl;
+    cout << " `___` ____/`____/|_|   |_____|___ /  |_|       " << endl;
+    cout << "--------------------------------------------------\n";
+    setColor(0x02);
+    cout << "Hello, Welcome to CSOPESY commandline!\n\n";
+
+    setColor(0x07);
+    cout << "Developers:\n";
+    cout << "Albarracin, Clarissa\n";
+    cout << "Garcia, Reina Althea\n";
+    cout << "Santos, Miko\n\n";
+
+    printLastUpdated();
+    cout << "\n\n";
+
+    setColor(0x0E);
+    cout << "Type 'exit' to quit, 'clear' to clear the screen\n"; 
+    cout << "--------------------------------------------------\n";
+    setColor(0x07);
+}
+
+pair<string, vector<string>> parseCommand(const string& input) {
+	istringstream stream(input);
+	string cmd;
+	stream >> cmd;
+
+	vector<string> args;
+	string arg;
+	
+	while (stream >> arg) {
+		args.push_back(arg);
+	}
+
+	return {cmd, args};
+}
+
+void initialize() {
+    // delete any existing previous logs
+    std::string consoleLogFile = "csopesy-log.txt";
+
+    try {
+        bool isDeleted = false;
+        
+        // Delete console-log.txt if it exists
+        if (std::filesystem::exists(consoleLogFile)) {
+            std::filesystem::remove(consoleLogFile);
+            isDeleted = true;
+        }
+        
+        if (isDeleted) {
+            std::cout << "Deleted previous log files.\n\n";
+        }
+        
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::cerr << "Error deleting files: " << e.what() << std::endl;
+    }
+
+
+    config = loadConfig("config.txt");
+
+    std::cout << ORANGE << "[Initializing System...]\n" << RESET;
+
+    std::cout << "Loaded configuration:\n";
+    std::cout << "  Scheduler type     : " << ORANGE << config.schedulerType    << RESET << "\n";
+    std::cout << "  Number of CPUs     : " << ORANGE << config.numCPUs          << RESET << "\n";
+    std::cout << "  Quantum cycles     : " << ORANGE << config.quantumCycles    << RESET << "\n";
+    std::cout << "  Batch process freq : " << ORANGE << config.batchProcessFreq << RESET << "\n";
+    std::cout << "  Min instructions   : " << ORANGE << config.minInstructions  << RESET << "\n";
+    std::cout << "  Max instructions   : " << ORANGE << config.maxInstructions  << RESET << "\n";
+    std::cout << "  Delay per exec     : " << ORANGE << config.delaysPerExec    << RESET << "\n";
+
+    if (config.schedDomains > 1) {
+        std::cout << "  Scheduling domains : " << ORANGE << config.schedDomains     << RESET << "\n";
+        std::cout << "  Balance interval   : " << ORANGE << config.balanceInterval  << RESET << " ms\n";
+        std::cout << "  Balance threshold  : " << ORANGE << config.balanceThreshold << RESET << "\n";
+    }
+
+    if (config.schedulerType == "rr") {
+        std::cout << "  RR affinity wait   : " << ORANGE << config.rrAffinityWait   << RESET << "\n";
+    }
+
+    if (config.schedulerType == "mlfq") {
+        std::cout << "  MLFQ levels        : " << ORANGE << config.mlfqLevels       << RESET << "\n";
+        std::cout << "  MLFQ multipliers   : " << ORANGE;
+        for (auto multiplier : config.mlfqQuantumMultipliers) std::cout << multiplier << " ";
+        std::cout << RESET << "\n";
+        std::cout << "  MLFQ boost interval: " << ORANGE << config.mlfqBoostInterval << RESET << "\n";
+    }
+
+    if (config.schedulerType == "cfs") {
+        std::cout << "  CFS target latency : " << ORANGE << config.cfsTargetLatency  << RESET << "\n";
+        std::cout << "  CFS min granularity: " << ORANGE << config.cfsMinGranularity << RESET << "\n";
+    }
+
+    if (config.admissionMaxReady > 0 || config.admissionMaxInFlight > 0) {
+        std::cout << "  Admission limits   : " << ORANGE << config.admissionMaxReady << " ready, "
+                  << config.admissionMaxInFlight << " in flight (" << config.admissionPolicy << ")" << RESET << "\n";
+    }
+
+    if (config.optimizePrograms) {
+        std::cout << "  Program optimizer  : " << ORANGE << "on" << RESET << "\n";
+    }
+
+    if (config.processLogSink) {
+        std::cout << "  Process log sink   : " << ORANGE << "on" << RESET
+                  << " (" << config.logSinkBuffer << " records/core, "
+                  << config.logSinkMaxOpenFiles << " open files, "
+                  << config.logSinkFlushInterval << " ms)\n";
+    }
+
+    std::cout << "\nStarting scheduler...\n";
+    buildScheduler();
+}
+
+// Builds and starts the scheduler (and the log sink) described by config; false if the config is invalid
+bool buildScheduler() {
+    CpuAffinity affinity;
+    auto built = makeScheduler(config, affinity);
+    if (!built) return false;
+    startScheduler(std::move(built), affinity);
+    return true;
+}
+
+/*
+    Builds, but does not start, the scheduler settings describe, and parses its
+    cpu-affinity. Touches no global state, so a restore can check a checkpoint's config
+    before tearing the running system down. nullptr (with the reason printed) if invalid.
+*/
+std::unique_ptr<Scheduler> makeScheduler(const Config& settings, CpuAffinity& affinity) {
+    std::string affinityError;
+    if (!CpuAffinity::parse(settings.cpuAffinity, affinity, affinityError)) {
+        std::cout << "Invalid cpu-affinity in config file: " << affinityError << ".\n\n";
+        return nullptr;
+    }
+
+    std::unique_ptr<Scheduler> built;
+    if (settings.schedDomains > 1) {
+        // split the cores as evenly as possible, one scheduler of the configured type per domain
+        int domainCount = std::min(settings.schedDomains, settings.numCPUs);
+        std::vector<std::unique_ptr<Scheduler>> domains;
+        for (int d = 0; d < domainCount; ++d) {
+            int domainCores = settings.numCPUs / domainCount + (d < settings.numCPUs % domainCount ? 1 : 0);
+            auto domain = createScheduler(domainCores, settings.schedulerType, settings);
+            if (!domain) break;
+            domains.push_back(std::move(domain));
+        }
+        if (domains.size() == static_cast<size_t>(domainCount)) {
+            built = std::make_unique<DomainScheduler>(std::move(domains), settings.delaysPerExec,
+                                                      settings.balanceInterval, settings.balanceThreshold);
+        }
+    } else {
+        built = createScheduler(settings.numCPUs, settings.schedulerType, settings);
+        if (built) built->setCoreCapacity(std::max(settings.numCPUs, settings.maxCPUs));
+    }
+
+    if (!built) std::cout << "Invalid scheduler type in config file.\n\n";
+    return built;
+}
+
+// Installs a scheduler from makeScheduler(config, ...) as the running one and starts it with the log sink
+void startScheduler(std::unique_ptr<Scheduler> built, const CpuAffinity& affinity) {
+    scheduler = std::move(built);
+
+    if (config.processLogSink) {
+        logSink = std::make_unique<ProcessLogSink>(scheduler->getCoreCapacity(), config.logSinkBuffer,
+                                                   config.logSinkMaxOpenFiles, config.logSinkFlushInterval);
+        logSink->start();
+        Process::setLogSink(logSink.get());
+    }
+
+    ProgramImage::setOptimize(config.optimizePrograms);
+    applyCpuAffinity(affinity);
+    scheduler->start();
+
+    std::string label = config.schedulerType;
+    std::transform(label.begin(), label.end(), label.begin(), ::toupper);
+    std::cout << ORANGE << "[" << label << " Scheduler started with " << config.numCPUs << " cores";
+    if (config.schedulerType == "mlfq") std::cout << ", " << config.mlfqLevels << " levels";
+    if (config.schedDomains > 1) std::cout << " in " << std::min(config.schedDomains, config.numCPUs) << " domains";
+    std::cout << "]" << RESET << "\n\n";
+}
+
+/*
+    Pins core executor threads, then scheduler threads, then the batch generator, in that
+    order along the affinity's CPU sequence (see CpuAffinity), and prints which host CPU
+    each thread got. Must run before scheduler->start(); with "none" it only unpins
+    executor threads a previous configuration pinned.
+*/
+void applyCpuAffinity(const CpuAffinity& affinity) {
+    unsigned workers = CoreExecutor::shared().getThreadCount();
+    size_t schedulerThreads = scheduler->getSchedulerThreadCount();
+    std::vector<int> plan = affinity.plan(workers + schedulerThreads + 1);
+
+    CoreExecutor::shared().setWorkerCpus(std::vector<int>(plan.begin(), plan.begin() + workers));
+    scheduler->setSchedulerCpus(std::vector<int>(plan.begin() + workers, plan.end() - 1));
+    generatorCpu = plan.back();
+
+    if (affinity.getMode() == CpuAffinity::Mode::None) return;
+
+    auto printThread = [](const std::string& name, int cpu) {
+        std::cout << "    " << std::setw(15) << std::left << name << std::right << " -> "
+                  << (cpu < 0 ? std::string("any CPU") : "CPU " + std::to_string(cpu)) << "\n";
+    };
+    std::cout << "  CPU affinity       : " << ORANGE << affinity.describe() << RESET
+              << " (" << CpuAffinity::hostCpuCount() << " host CPUs)\n";
+    for (unsigned i = 0; i < workers; ++i) printThread("core worker " + std::to_string(i), plan[i]);
+    for (size_t i = 0; i < schedulerThreads; ++i) {
+        // DomainScheduler: one scheduler per domain, then the balancer
+        std::string name = schedulerThreads == 1 ? "scheduler"
+                         : i + 1 == schedulerThreads ? "balancer" : "domain " + std::to_string(i);
+        printThread(name, plan[workers + i]);
+    }
+    printThread("generator", generatorCpu);
+}
+
+// Builds a scheduler of the given type over the given number of cores, with settings' quanta and delays (nullptr if the type is unknown)
+std::unique_ptr<Scheduler> createScheduler(int cores, const std::string& type, const Config& settings) {
+    if (type == "fcfs") {
+        return std::make_unique<FCFSScheduler>(cores, settings.delaysPerExec);
+    } 
+    
+    else if (type == "rr") {
+        return std::make_unique<RRScheduler>(cores, settings.delaysPerExec, settings.quantumCycles,
+                                             settings.rrAffinityWait);
+    } 
+
+    else if (type == "mlfq") {
+        return std::make_unique<MLFQScheduler>(cores, settings.delaysPerExec, settings.quantumCycles,
+                                               settings.mlfqLevels, settings.mlfqQuantumMultipliers,
+                                               settings.mlfqBoostInterval);
+    } 
+
+    else if (type == "sjf" || type == "srtf") {
+        return std::make_unique<SJFScheduler>(cores, settings.delaysPerExec, type == "srtf");
+    } 
+
+    else if (type == "cfs") {
+        return std::make_unique<CFSScheduler>(cores, settings.delaysPerExec,
+                                              settings.cfsTargetLatency, settings.cfsMinGranularity);
+    } 
+
+    return nullptr;
+}
+
+void scheduler_start(std::vector<std::shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
+	startBatchGeneration(processList, consolePanel);
+}
+
+void scheduler_stop() {
+	stopBatchGeneration();
+}
+
+void report_util(const std::vector<std::shared_ptr<Process>>& allProcesses,
+                const std::vector<std::shared_ptr<Process>>& runningProcesses) {
+
+    std::filesystem::path logPath = std::filesystem::current_path() / "csopesy-log.txt";
+    std::ofstream log("csopesy-log.txt");
+    if (!log.is_open()) {
+        std::cerr << "Failed to open csopesy-log.txt for writing.\n";
+        return;
+    }
+
+    log << "========== System Summary ============\n";
+    if (scheduler) {
+        printUtilization(log, true);
+        log << "Cores Used: " << scheduler->getBusyCoreCount() << "\n";
+        log << "Cores available: " << scheduler->getAvailableCoreCount() << "\n";
+        log << "Sleeping processes: " << scheduler->getWaitingCount() << "\n";
+        log << "Core executor: " << CoreExecutor::shared().getThreadCount() << " host threads, "
+            << CoreExecutor::shared().getResumeCount() << " core task resumes\n";
+        // how each kind of handoff was woken: spinning, yielding, parked or timed out
+        auto printWaits = [&log](const char* name, const WaitStats& stats) {
+            log << name << stats.spun << " spin, " << stats.yielded << " yield, " << stats.parked << " park, "
+                << stats.timedOut << " timeout (spin budget " << stats.spinBudgetNs << " ns)\n";
+        };
+        printWaits("Executor wakeups: ", CoreExecutor::shared().getWaitStats());
+        printWaits("Scheduler wakeups: ", Scheduler::wakeTuning().getStats());
+        printWaits("Core task joins: ", CoreTask::joinTuning().getStats());
+        if (logSink) log << "Log records dropped: " << logSink->getDroppedCount() << "\n";
+        log << "Program images: " << ProgramImage::getAliveCount() << " shared by " << allProcesses.size() << " processes\n";
+        if (config.reapRetention > 0 || archive.size() > 0) {
+            log << "Archived processes: " << archive.size() << " (reaped " << config.reapRetention << " ms after finishing";
+            if (archive.getSpillFailures() > 0) log << ", " << archive.getSpillFailures() << " log spills failed";
+            log << ")\n";
+        }
+        if (config.optimizePrograms) {
+            OptimizerStats stats = ProgramImage::getOptimizerStats();
+            log << "Optimized instructions: " << stats.dead << " dead, " << stats.constant << " constant of "
+                << stats.instructions << " in " << stats.images << " images\n";
+        }
+        if (admission) {
+            // 0 = no limit
+            auto limit = [](size_t max) { return max > 0 ? std::to_string(max) : std::string("-"); };
+            AdmissionStats stats = admission->getStats();
+            log << "Admission (" << AdmissionControl::policyName(admission->getPolicy()) << "): ready queue "
+                << stats.ready << " / " << limit(admission->getMaxReady()) << " (peak " << stats.peakReady << "), in flight "
+                << stats.inFlight << " / " << limit(admission->getMaxInFlight()) << " (peak " << stats.peakInFlight << ")\n";
+            log << "Admitted: " << stats.admitted << ", rejected: " << stats.rejected << ", deferred: " << stats.deferred
+                << ", interval: " << stats.interval << " ms\n";
+        }
+    } else {
+        log << "Scheduler not running.\n";
+    }
+    log << "======================================\n";
+
+    // Running processes
+    std::unordered_set<std::shared_ptr<Process>> runningSet(runningProcesses.begin(), runningProcesses.end());
+
+    log << "Running Processes:\n";
+    for (const auto& proc : runningProcesses) {
+        auto snapshot = proc->getAtomicSnapshot();
+        if (snapshot.processName == "MAIN_SCREEN") continue;
+
+        log << std::left << std::setw(15) << snapshot.processName
+                  << snapshot.time << "   "
+                  << "Core: " << snapshot.coreNo <<  "   "
+                  << snapshot.completedCommands
+                  << " / "
+                  << snapshot.totalNoCommands << "   "
+                  << "Migrations: " << snapshot.migrations
+                  << "\n";
+    }
+
+    log << "\nFinished Processes:\n";
+    archive.forEach([&](const ProcessRecord& record) {
+        log << record.name << "\t\t"
+            << Process::formatRawTime(record.created) << "   "
+            << "Finished!"                            << "   "
+            << record.completedCommands << " / "
+            << record.totalCommands << "   "
+            << "Migrations: " << record.migrations
+            << "\n";
+    });
+    for (const auto& proc : allProcesses) {
+        if (proc->getProcessName() == "MAIN_SCREEN") continue;
+
+        if (proc->isFinished() && !runningSet.count(proc)) {
+            log << proc->getProcessName() << "\t\t"
+                      << proc->getRawTime()                            << "   "
+                      << "Finished!"                                << "   "
+                      << proc->getCompletedCommands() << " / "
+                      << proc->getTotalNoOfCommands() << "   "
+                      << "Migrations: " << proc->getMigrations()
+                      << "\n";
+        }
+    }
+
+    log << "======================================\n\n";
+
+    log.close();
+    setColor(0x02); //color green
+    cout << "Report generated at: " << logPath << "!\n\n";
+    setColor(0x07); //default
+}
+
+void printSystemSummary() {
+    cout << "========== System Summary ============\n";
+    printUtilization(cout, false);
+    cout << "Cores Used: "         << scheduler->getBusyCoreCount() << "\n";
+    cout << "Cores available: "    << scheduler->getAvailableCoreCount() << "\n";
+    cout << "Sleeping processes: " << scheduler->getWaitingCount() << "\n";
+    cout << "======================================\n";
+}
+
+/*
+    Time-weighted utilization: share of core time spent running a process over the
+    last 1, 10 and 60 seconds (shorter if the scheduler has not run that long).
+    With perCore, also each core's busy / idle / sleeping split over the last 60 s
+*/
+void printUtilization(std::ostream& out, bool perCore) {
+    out << "CPU Utilization: " << std::fixed << std::setprecision(0)
+        << scheduler->getUtilization(1).busyPercent() << "% (1s)   "
+        << scheduler->getUtilization(10).busyPercent() << "% (10s)   "
+        << scheduler->getUtilization(60).busyPercent() << "% (60s)\n";
+
+    if (perCore) {
+        auto cores = scheduler->getCoreUtilization(60);
+        out << "Per-core, last 60s (busy / idle / sleeping):\n";
+        for (size_t i = 0; i < cores.size(); ++i) {
+            double total = std::max(1ULL, cores[i].total());
+            out << "  Core " << std::setw(3) << i << ": "
+                << std::setw(3) << 100.0 * cores[i].busy / total << "% / "
+                << std::setw(3) << 100.0 * cores[i].idle / total << "% / "
+                << std::setw(3) << 100.0 * cores[i].sleeping / total << "%\n";
+        }
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
+
+void printHelpMenu() {
+    cout << "  initialize        - Initialize system\n";
+    cout << "  screen -s <name>  - Start new screen (optional [nice] -20..19 for CFS)\n";
+    cout << "  screen -r <name>  - Resume existing screen\n";
+    cout << "  scheduler-start   - Run scheduler start\n";
+    cout << "  scheduler-stop    - Stop scheduler\n";
+    cout << "  report-util       - Display utilization report\n";
+    cout << "  clear             - Clear the screen\n";
+    cout << "  screen -ls        - List all screen processes\n";
+    cout << "  cores add <n>     - Add n cores while running (up to max-cpu)\n";
+    cout << "  cores remove <n>  - Remove n cores, their processes go back to the ready queue\n";
+    cout << "  top               - Live utilization, cores and busiest processes (any key exits)\n";
+    cout << "  trace start       - Start recording scheduler events\n";
+    cout << "  trace stop [file] - Stop and save the trace (default scheduler-trace.bin)\n";
+    cout << "  checkpoint <file> - Save every process, the queues and the config to a file\n";
+    cout << "  restore <file>    - Replace the running system with a saved checkpoint\n";
+    cout << "  compare [n] [...] - Run one n-process workload through every (or the listed) scheduler\n";
+    cout << "  help              - Show this help menu\n";
+    cout << "  exit              - Exit the program\n\n";
+}
+
+void handleExit() {
+    exit(0);
+}
+
+void clear() {
+	cout << "\033c" << flush;
+	header();
+}
+
+void clearToProcessScreen() {
+	cout << "\033c" << flush;
+}
+
+void startBatchGeneration(std::vector<std::shared_ptr<Process>>& processList, ConsolePanel& consolePanel) {
+    if (isBatchGenerating) {
+        std::cout << "Batch generation already running!\n\n";
+        return;
+    }
+
+    AdmissionPolicy policy;
+    if (!AdmissionControl::parsePolicy(config.admissionPolicy, policy)) {
+        std::cout << "Invalid admission-policy in config file.\n\n";
+        return;
+    }
+    admission = std::make_unique<AdmissionControl>(config.admissionMaxReady, config.admissionMaxInFlight,
+                                                   policy, config.batchProcessFreq);
+
+    isBatchGenerating = true;
+
+    batchGeneratorThread = std::thread([&processList, &consolePanel]() {
+        CpuAffinity::pinCurrentThread(generatorCpu);
+        unsigned long long localTicks = 0;
+        std::vector<std::shared_ptr<Process>> unfinished; // generated here, pruned as they finish
+
+        while (isBatchGenerating) {
+            // std::this_thread::sleep_for(std::chrono::milliseconds(1)); // 1 tick = 1 ms
+            localTicks++;
+
+            if (localTicks >= admission->getInterval()) {
+                std::erase_if(unfinished, [](const std::shared_ptr<Process>& proc) { return proc->isFinished(); });
+                AdmissionDecision decision = admission->admit(scheduler->getReadyQueueSize(), unfinished.size());
+                if (decision != AdmissionDecision::Wait) localTicks = 0; // blocked: retry next ms
+
+                if (decision == AdmissionDecision::Admit) {
+                    // Generate process name
+                    std::ostringstream ss;
+                    ss << "p" << std::setw(2) << std::setfill('0') << processCounter++;
+                    std::string procName = ss.str();
+
+                    // Random instruction count
+                    unsigned long long total = config.minInstructions + rand() % (config.maxInstructions - config.minInstructions + 1);
+                    auto newProc = std::make_shared<Process>(procName, total);
+
+                    // Generate random instructions (identical programs share one image)
+                    newProc->setProgram(ProgramImage::create(generateRandomInstructions(total)));
+
+                    {
+                        std::lock_guard<std::mutex> lock(processListMutex);
+                        processList.push_back(newProc);
+                    }
+
+                    // Create console screen
+                    int dummyCurr = rand() % 100;
+                    auto procConsole = std::make_shared<Console>(procName, dummyCurr, total, newProc->getProcessNo());
+                    consolePanel.addConsolePanel(procConsole);
+
+                    scheduler->addProcess(newProc);
+                    unfinished.push_back(newProc);
+                    batchProcessCount++;
+                }
+            }
+            
+            // check frequently even if batchProcessFreq is high
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::cout << "Started batch process generation.\n\n";
+}
+
+/*
+    Reaper: every REAP_INTERVAL_MS, processes finished for at least reap-retention ms
+    leave processList for the archive (ProcessArchive). Runs from initialize to exit;
+    with reap-retention 0 it only wakes up and goes back to sleep.
+*/
+void startReaper(std::vector<std::shared_ptr<Process>>& processList) {
+    static constexpr int REAP_INTERVAL_MS = 100;
+    isReaping = true;
+    reaperThread = std::thread([&processList]() {
+        while (isReaping) {
+            if (config.reapRetention > 0) {
+                std::lock_guard<std::mutex> lock(processListMutex);
+                archive.reap(processList, std::chrono::milliseconds(config.reapRetention), config.reapSpillLogs);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(REAP_INTERVAL_MS));
+        }
+    });
+}
+
+void stopReaper() {
+    isReaping = false;
+    if (reaperThread.joinable())
+        reaperThread.join();
+}
+
+void stopBatchGeneration() {
+    if (!isBatchGenerating) {
+        std::cout << "No batch generation is running.\n\n";
+        return;
+    }
+
+    isBatchGenerating = false;
+
+    if (batchGeneratorThread.joinable())
+        batchGeneratorThread.join();
+
+    std::cout << "Stopped batch process generation.\n";
+    std::cout << "Total processes generated: " << batchProcessCount << "\n";
+    unsigned long long rejected = admission->getStats().rejected;
+    if (rejected > 0) std::cout << "Rejected by admission control: " << rejected << "\n";
+    std::cout << "\n";
+}
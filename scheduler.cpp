@@ -1,39 +1,230 @@
 #include "Scheduler.h"
+#include "CpuAffinity.h"
+#include <chrono>
+#include <algorithm>
 
 Scheduler::Scheduler(int cores, unsigned long long delay)
-    : coreCount(cores), delayPerExec(delay),
-      coreTicks(cores) // directly initialize vector with cores default-constructed atomics
+    : coreCount(cores), coreCapacity(cores), delayPerExec(delay),
+      coreCounters(cores), // directly initialize vector with cores default-constructed counters
+      utilizationHistory(static_cast<size_t>(HISTORY_SECONDS) * cores * 3)
 {
-    for (int i = 0; i < coreCount; ++i)
-        coreTicks[i].store(0);
+}
+
+// Counters are atomics and cannot be moved, so the storage is rebuilt rather than resized
+void Scheduler::setCoreCapacity(int capacity) {
+    if (running || capacity <= coreCapacity) return;
+
+    std::vector<CoreCounters>(capacity).swap(coreCounters);
+    std::vector<std::atomic<unsigned long long>>(static_cast<size_t>(HISTORY_SECONDS) * capacity * 3).swap(utilizationHistory);
+    coreCapacity = capacity;
 }
 
 Scheduler::~Scheduler() {}
 
+std::atomic<SchedulerTrace*> Scheduler::trace{nullptr};
+
 void Scheduler::addProcess(const std::shared_ptr<Process>& proc) {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    readyQueue.push(proc);
+    proc->transitionState(ProcessState::NEW, ProcessState::READY);
+    traceEvent(TraceEvent::Arrival, proc, -1);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        readyQueue.push(proc);
+    }
+    schedulerWake.notifyOne();
+}
+
+SpinTuning& Scheduler::wakeTuning() {
+    static SpinTuning tuning;
+    return tuning;
 }
 
 /*
     Used to know how many cores are currently busy
-    A core is considered busy if it has an assigned process that is not finished
-    This function iterates through all cores and checks if they are busy
-    It locks each core's mutex to ensure thread safety while checking the busy status
+    A core is considered busy from the moment a process is dispatched to it until the
+    core is released. Reads each core's occupied flag, so no core lock is taken
 */
 int Scheduler::getBusyCoreCount() const {
     int count = 0;
-    for (const auto& core : cores) {
-        std::lock_guard<std::mutex> lock(core->lock);
-        if (core->assignedProcess != nullptr) { // edited
-            count++;
-        }
+    for (const auto& counters : coreCounters) {
+        if (counters.occupied.load(std::memory_order_relaxed)) count++;
     }
     return count;
 }
 
+// One 1 ms sample of every core's state, plus the per-second history snapshot
+void Scheduler::sampleCoreStates(bool anySleeping) {
+    int active = coreCount;
+    for (int i = 0; i < active; ++i) {
+        auto& counters = coreCounters[i];
+        if (counters.occupied.load(std::memory_order_relaxed)) counters.busyTicks.fetch_add(1, std::memory_order_relaxed);
+        else if (anySleeping) counters.sleepingTicks.fetch_add(1, std::memory_order_relaxed);
+        else counters.idleTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    unsigned long long tick = systemTick.load();
+    if (tick % 1000 != 0) return;
+
+    unsigned long long second = tick / 1000;
+    size_t base = (second % HISTORY_SECONDS) * coreCapacity * 3;
+    for (int i = 0; i < coreCapacity; ++i) {
+        utilizationHistory[base + i * 3].store(coreCounters[i].busyTicks.load(), std::memory_order_relaxed);
+        utilizationHistory[base + i * 3 + 1].store(coreCounters[i].idleTicks.load(), std::memory_order_relaxed);
+        utilizationHistory[base + i * 3 + 2].store(coreCounters[i].sleepingTicks.load(), std::memory_order_relaxed);
+    }
+    historySeconds.store(second, std::memory_order_release);
+}
+
+std::vector<CoreUtilization> Scheduler::getCoreUtilization(unsigned windowSeconds) const {
+    int active = coreCount;
+    std::vector<CoreUtilization> result(active);
+    for (int i = 0; i < active; ++i) {
+        result[i].busy = coreCounters[i].busyTicks.load(std::memory_order_relaxed);
+        result[i].idle = coreCounters[i].idleTicks.load(std::memory_order_relaxed);
+        result[i].sleeping = coreCounters[i].sleepingTicks.load(std::memory_order_relaxed);
+    }
+
+    // slot 0 was never written and holds zeros, so a window longer than the uptime is "since start"
+    unsigned long long seconds = historySeconds.load(std::memory_order_acquire);
+    windowSeconds = std::min(windowSeconds, MAX_WINDOW_SECONDS);
+    if (windowSeconds == 0 || seconds < windowSeconds) return result;
+
+    size_t base = ((seconds - windowSeconds) % HISTORY_SECONDS) * coreCapacity * 3;
+    for (int i = 0; i < active; ++i) {
+        result[i].busy -= std::min(result[i].busy, utilizationHistory[base + i * 3].load(std::memory_order_relaxed));
+        result[i].idle -= std::min(result[i].idle, utilizationHistory[base + i * 3 + 1].load(std::memory_order_relaxed));
+        result[i].sleeping -= std::min(result[i].sleeping, utilizationHistory[base + i * 3 + 2].load(std::memory_order_relaxed));
+    }
+    return result;
+}
+
+std::vector<unsigned long long> Scheduler::getCoreInstructionCounts() const {
+    std::vector<unsigned long long> result;
+    int active = coreCount;
+    for (int i = 0; i < active; ++i) result.push_back(coreCounters[i].executed.load(std::memory_order_relaxed));
+    return result;
+}
+
+CoreUtilization Scheduler::getUtilization(unsigned windowSeconds) const {
+    CoreUtilization sum;
+    for (const auto& core : getCoreUtilization(windowSeconds)) {
+        sum.busy += core.busy;
+        sum.idle += core.idle;
+        sum.sleeping += core.sleeping;
+    }
+    return sum;
+}
+
+size_t Scheduler::getReadyQueueSize() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return readyQueue.size();
+}
+
+std::shared_ptr<Process> Scheduler::stealReadyProcess() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (readyQueue.empty()) return nullptr;
+
+    auto proc = readyQueue.front();
+    readyQueue.pop();
+    return proc;
+}
+
+size_t Scheduler::getWaitingCount() const {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    return sleepQueue.size();
+}
+
+// Park a process for the given number of ticks; its core must already be released
+// WAITING is set under sleepMutex, so a checkpoint never sees a WAITING process that is not parked yet
+void Scheduler::sleepProcess(const std::shared_ptr<Process>& proc, unsigned long long ticks) {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    proc->transitionState(ProcessState::RUNNING, ProcessState::WAITING);
+    sleepQueue.push({systemTick.load() + ticks, nextSleepSeq++, proc});
+}
+
+std::vector<std::shared_ptr<Process>> Scheduler::readyList() const {
+    auto copy = readyQueue;
+    std::vector<std::shared_ptr<Process>> result;
+    for (; !copy.empty(); copy.pop()) result.push_back(copy.front());
+    return result;
+}
+
+void Scheduler::captureQueues(const QueueCapture& capture) {
+    std::scoped_lock lock(queueMutex, sleepMutex);
+    auto copy = sleepQueue;
+    unsigned long long now = systemTick.load();
+    SleepingList sleeping;
+    for (; !copy.empty(); copy.pop()) {
+        const auto& entry = copy.top();
+        sleeping.push_back({entry.proc, entry.wakeTick > now ? entry.wakeTick - now : 0});
+    }
+    capture(readyList(), sleeping);
+}
+
+void Scheduler::restoreSleeping(const std::shared_ptr<Process>& proc, unsigned long long ticks) {
+    proc->setCoreNum(-1);
+    proc->setState(ProcessState::WAITING);
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    sleepQueue.push({systemTick.load() + ticks, nextSleepSeq++, proc});
+}
+
+void Scheduler::adoptProcess(const std::shared_ptr<Process>& proc) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        readyQueue.push(proc);
+    }
+    schedulerWake.notifyOne();
+}
+
+void Scheduler::wakeProcess(const std::shared_ptr<Process>& proc) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        readyQueue.push(proc);
+    }
+    schedulerWake.notifyOne();
+}
+
+/*
+    Advances systemTick every millisecond and wakes every sleeper whose tick has come.
+    Only the heap top is inspected per tick, so a tick with nothing due costs O(1)
+    and each wake costs O(log n).
+*/
+void Scheduler::startSleepTimer() {
+    sleepTimerThread = std::thread([this]() {
+        CpuAffinity::pinCurrentThread(schedulerCpu);
+        std::vector<std::shared_ptr<Process>> due;
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            unsigned long long now = ++systemTick;
+            bool anySleeping;
+
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                while (!sleepQueue.empty() && sleepQueue.top().wakeTick <= now) {
+                    due.push_back(sleepQueue.top().proc);
+                    sleepQueue.pop();
+                }
+                anySleeping = !sleepQueue.empty();
+            }
+
+            sampleCoreStates(anySleeping);
+
+            for (auto& proc : due) {
+                proc->wake();
+                traceEvent(TraceEvent::Wake, proc, -1);
+                wakeProcess(proc);
+            }
+            due.clear();
+        }
+    });
+}
+
+void Scheduler::stopSleepTimer() {
+    if (sleepTimerThread.joinable()) sleepTimerThread.join();
+}
+
 int Scheduler::getAvailableCoreCount() const {
-    return coreCount - getBusyCoreCount();
+    // cores being removed still count as busy until they have drained
+    return std::max(0, coreCount - getBusyCoreCount());
 }
 
 std::vector<std::shared_ptr<Process>> Scheduler::getRunningProcesses() const {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Process.h"
+#include "SchedulerTrace.h"
+#include "CoreExecutor.h"
 #include <vector>
 #include <queue>
 #include <memory>
@@ -8,36 +10,153 @@
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <functional>
+
+// Ticks a core spent in each state over some window (1 tick = 1 ms sample)
+struct CoreUtilization {
+    unsigned long long busy = 0;     // running a process
+    unsigned long long idle = 0;     // nothing to run
+    unsigned long long sleeping = 0; // nothing to run while this scheduler had processes blocked on SLEEP
+
+    unsigned long long total() const { return busy + idle + sleeping; }
+    double busyPercent() const { return total() ? 100.0 * busy / total() : 0.0; }
+};
 
 class Scheduler {
 protected:
-    int coreCount;
+    std::atomic<int> coreCount; // active cores, changed at runtime by addCores / removeCores
+    int coreCapacity;           // per-core storage allocated, the most cores this scheduler can grow to
+    int coreOffset = 0; // first global core id, non-zero when this scheduler is one domain of many
     unsigned long long delayPerExec;
     std::atomic<bool> running{false};
 
+    // Emulated cores run as CoreTasks on CoreExecutor's shared host threads, not threads of their own
     struct CPUCore {
-        std::thread thread;
+        CoreTask task;    // FCFS core worker
         std::shared_ptr<Process> assignedProcess;
         std::mutex lock;
-        std::condition_variable cv;
+        CoreEvent wake;   // a process was assigned, or the worker should stop
         bool busy = false;
+        std::atomic<bool> sliceDone{false}; // set by a slice thread when it returns the core
+        std::atomic<bool> preemptRequested{false}; // asks the running slice to stop early
+        unsigned long long sleepTicks = 0; // set with sliceDone when the slice ended on a SLEEP
     };
 
     std::vector<std::unique_ptr<CPUCore>> cores;
     std::thread schedulerThread;
     std::thread tickThread;
+    int schedulerCpu = -1; // host CPU of schedulerThread and the sleep timer (cpu-affinity), -1 = unpinned
 
     std::queue<std::shared_ptr<Process>> readyQueue;
-    std::mutex queueMutex;
+    mutable std::mutex queueMutex;
 
     std::atomic<int> cpuTicks{0};
 
-    std::vector<std::atomic<unsigned long long>> coreTicks; // one tick counter per core
-    // std::atomic<int> systemTick{0};                      // used for batch generation
+    /*
+    Per-core counters. The core's own tick is written by whoever runs that core, the
+    state counters by the sleep timer thread's 1 ms sample, so each group gets its own
+    cache line and neighbouring cores never write to a line another core is using.
+    */
+    struct alignas(64) CoreCounters {
+        std::atomic<unsigned long long> tick{0};
+        std::atomic<unsigned long long> executed{0}; // instructions run on this core
+        std::atomic<bool> occupied{false}; // set on dispatch, cleared on release
+
+        alignas(64) std::atomic<unsigned long long> busyTicks{0};
+        std::atomic<unsigned long long> idleTicks{0};
+        std::atomic<unsigned long long> sleepingTicks{0};
+    };
+    std::vector<CoreCounters> coreCounters;
+    std::atomic<unsigned long long> systemTick{0};          // 1 ms ticks, drives sleepQueue
+
+    /*
+    Once a second the sampler copies every core's cumulative busy/idle/sleeping counts
+    into slot (second % HISTORY_SECONDS); a window of W seconds is the live counters
+    minus the slot from W seconds ago. Every value is atomic and the slot being
+    written is never one a window up to MAX_WINDOW_SECONDS reads, so no lock is needed.
+    */
+    static constexpr unsigned HISTORY_SECONDS = 64;
+    static constexpr unsigned MAX_WINDOW_SECONDS = 60;
+    std::vector<std::atomic<unsigned long long>> utilizationHistory; // [slot][core][busy, idle, sleeping]
+    std::atomic<unsigned long long> historySeconds{0};
+
+    // Held by the dispatcher for one pass and by addCores / removeCores while they
+    // change coreCount, so a core is never handed a process while it is being removed
+    std::mutex resizeMutex;
+
+    /*
+    Wakes the dispatcher: new or woken processes, cores handed back, stop. The
+    dispatcher takes a ticket before its pass and waits with it after, so anything
+    notified during the pass makes the wait return at once (see AdaptiveWait).
+    */
+    AdaptiveWait schedulerWake{wakeTuning()};
+
+    void setCoreOccupied(int coreId, bool occupied) {
+        coreCounters[coreId].occupied.store(occupied, std::memory_order_relaxed);
+    }
+    void sampleCoreStates(bool anySleeping); // called by the sleep timer every tick
+
+    void addExecuted(int coreId, unsigned long long count) {
+        coreCounters[coreId].executed.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    std::vector<CoreTask> tickTasks; // per-core clocks (RR)
+
+    /*
+    Processes blocked on SLEEP. Instead of holding a core while they sleep, they are
+    parked here ordered by the systemTick at which they wake; the sleep timer thread
+    hands each one back to wakeProcess once its tick arrives.
+    */
+    struct SleepEntry {
+        unsigned long long wakeTick;
+        unsigned long long seq; // FIFO among equal wake ticks
+        std::shared_ptr<Process> proc;
+
+        bool operator>(const SleepEntry& other) const {
+            if (wakeTick != other.wakeTick) return wakeTick > other.wakeTick;
+            return seq > other.seq;
+        }
+    };
+    std::priority_queue<SleepEntry, std::vector<SleepEntry>, std::greater<SleepEntry>> sleepQueue;
+    mutable std::mutex sleepMutex;
+    unsigned long long nextSleepSeq = 0;
+    std::thread sleepTimerThread;
+
+    void startSleepTimer();
+    void stopSleepTimer();
+    void sleepProcess(const std::shared_ptr<Process>& proc, unsigned long long ticks);
 
-    std::vector<std::thread> tickThreads;
+    // Puts a process whose SLEEP has ended back on the ready queue
+    virtual void wakeProcess(const std::shared_ptr<Process>& proc);
+
+    virtual std::vector<std::shared_ptr<Process>> readyList() const; // dispatch order, caller holds queueMutex
+
+    // Active event trace (trace start), shared by every scheduler instance
+    static std::atomic<SchedulerTrace*> trace;
+    bool traced = true; // false keeps this instance out of the trace (compare runs)
+
+    std::atomic<unsigned long long> dispatches{0}; // processes put on a core, i.e. context switches
+
+    // Records an event for this scheduler's core (local index), or an off-core event with -1
+    void traceEvent(TraceEvent event, const std::shared_ptr<Process>& proc, int core) {
+        if (event == TraceEvent::Dispatch) dispatches.fetch_add(1, std::memory_order_relaxed);
+        if (!traced) return;
+        SchedulerTrace* active = trace.load(std::memory_order_acquire);
+        if (!active || !active->isRunning()) return;
+        if (core < 0) active->record(event, proc->getProcessNo(), -1, systemTick.load());
+        else active->record(event, proc->getProcessNo(), coreOffset + core, getCoreTick(core));
+    }
+
+    // Most instructions a core runs per Process::executeBurst call when there is no
+    // delays-per-exec; bounds how long a burst holds the process lock
+    static constexpr unsigned long long BURST_SIZE = 64;
 
 public:
+    static void setTrace(SchedulerTrace* active) { trace.store(active, std::memory_order_release); }
+
+    // Spin budget shared by every scheduler's dispatcher wakeups (report-util)
+    static SpinTuning& wakeTuning();
+
     Scheduler(int cores, unsigned long long delay);
     virtual ~Scheduler();
 
@@ -45,23 +164,37 @@ public:
     virtual void stop() = 0;
 
     virtual void schedulerLoop() = 0;
-    virtual void coreWorker(int coreId) = 0;
+    virtual CoreTask coreWorker(int coreId) = 0;
 
     virtual void addProcess(const std::shared_ptr<Process>& proc);
     virtual int getBusyCoreCount() const;
+    virtual size_t getReadyQueueSize() const;
+    virtual size_t getWaitingCount() const; // processes blocked on SLEEP
+
+    // Time-weighted core states over the last windowSeconds (0 = since start), no locks taken
+    virtual std::vector<CoreUtilization> getCoreUtilization(unsigned windowSeconds) const;
+    CoreUtilization getUtilization(unsigned windowSeconds) const;
+
+    // Instructions each core has executed since start (for rates), no locks taken
+    virtual std::vector<unsigned long long> getCoreInstructionCounts() const;
     int getAvailableCoreCount() const;
     int getCPUTicks() const { return cpuTicks.load(); }
     
     // for ticks
     unsigned long long getCoreTick(int coreId) const {
-        if (coreId >= 0 && coreId < coreTicks.size())
-            return coreTicks[coreId].load();
+        if (coreId >= 0 && coreId < coreCounters.size())
+            return coreCounters[coreId].tick.load();
         return -1;
     }
 
     void incrementCoreTick(int coreId) {
-        if (coreId >= 0 && coreId < coreTicks.size())
-            coreTicks[coreId]++;
+        if (coreId >= 0 && coreId < coreCounters.size())
+            coreCounters[coreId].tick++;
+    }
+
+    void addCoreTicks(int coreId, unsigned long long ticks) {
+        if (coreId >= 0 && coreId < coreCounters.size())
+            coreCounters[coreId].tick += ticks;
     }
 
     /*
@@ -72,14 +205,57 @@ public:
     */
     virtual std::vector<std::shared_ptr<Process>> getRunningProcesses() const;
 
+    /*
+    Used by DomainScheduler to move waiting work between domains.
+    stealReadyProcess removes one queued process (nullptr if none) and
+    adoptProcess queues a process that was already waiting elsewhere (not traced as an Arrival).
+    */
+    virtual std::shared_ptr<Process> stealReadyProcess();
+    virtual void adoptProcess(const std::shared_ptr<Process>& proc);
+
+    /*
+    Used by checkpoint / restore. captureQueues locks the ready and sleep queues and,
+    while they stay locked, hands capture the queued processes in the order they would
+    be dispatched and the SLEEPing ones with the ticks left until they wake. Nothing is
+    dispatched, parked or woken until capture returns (processes already on a core keep
+    running), so capture must not call back into the scheduler. restoreSleeping parks
+    a restored process for that many ticks.
+    */
+    using ReadyList = std::vector<std::shared_ptr<Process>>;
+    using SleepingList = std::vector<std::pair<std::shared_ptr<Process>, unsigned long long>>;
+    using QueueCapture = std::function<void(const ReadyList& ready, const SleepingList& sleeping)>;
+    virtual void captureQueues(const QueueCapture& capture);
+    virtual void restoreSleeping(const std::shared_ptr<Process>& proc, unsigned long long ticks);
+
+    /*
+    cpu-affinity. getSchedulerThreadCount is how many host CPUs setSchedulerCpus wants,
+    one per scheduler thread (DomainScheduler: one per domain plus its balancer). Set
+    before start(); the threads pin themselves when they start.
+    */
+    virtual size_t getSchedulerThreadCount() const { return 1; }
+    virtual void setSchedulerCpus(const std::vector<int>& cpus) { schedulerCpu = cpus.empty() ? -1 : cpus.front(); }
+
+    // Set before start()
+    virtual void setTraced(bool enabled) { traced = enabled; }
+    virtual unsigned long long getDispatchCount() const { return dispatches.load(std::memory_order_relaxed); }
+
+    void setCoreOffset(int offset) { coreOffset = offset; }
+    int getCoreCount() const { return coreCount; }
 
-    // int getSystemTick() const {
-    //     return systemTick.load();
-    // }
+    /*
+    Elastic core pool. setCoreCapacity (before start) reserves per-core storage for up
+    to 'capacity' cores; addCores then starts idle cores above coreCount and removeCores
+    retires the highest-numbered ones, putting whatever they ran back on the ready queue.
+    Both return how many cores actually changed; schedulers that cannot resize return 0.
+    */
+    void setCoreCapacity(int capacity);
+    int getCoreCapacity() const { return coreCapacity; }
+    virtual int addCores(int count) { return 0; }
+    virtual int removeCores(int count) { return 0; }
 
-    // void incrementSystemTick() {
-    //     systemTick++;
-    // }
+    unsigned long long getSystemTick() const {
+        return systemTick.load();
+    }
 };
 
 
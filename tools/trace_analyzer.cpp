@@ -0,0 +1,202 @@
+/*
+    Offline analyzer for the binary traces written by `trace stop`.
+
+    g++ -std=c++20 tools/trace_analyzer.cpp -o trace_analyzer.exe
+    trace_analyzer.exe scheduler-trace.bin [columns]
+
+    Prints
+      - a per-core Gantt timeline (one character per time bucket: the running PID's
+        last digit, '*' if several processes ran in the bucket, '.' if idle)
+      - total core utilization per time bucket
+      - the queueing delay distribution: time from becoming ready (arrival, preemption
+        or wakeup) to the next dispatch
+*/
+#include "../SchedulerTrace.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+struct RunInterval {
+    uint32_t pid;
+    uint64_t begin;
+    uint64_t end;
+};
+
+static const char* eventName(uint8_t event) {
+    static const char* names[] = {"arrival", "dispatch", "preempt", "sleep", "wake", "finish"};
+    return event < 6 ? names[event] : "unknown";
+}
+
+static bool readTrace(const std::string& path, TraceFileHeader& header, std::vector<TraceRecord>& records) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(header.magic, SchedulerTrace::MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != SchedulerTrace::VERSION) return false;
+
+    records.resize(header.recordCount);
+    in.read(reinterpret_cast<char*>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+    return static_cast<bool>(in);
+}
+
+// Pairs each dispatch with the event that took the process off that core
+static std::vector<std::vector<RunInterval>> buildIntervals(const std::vector<TraceRecord>& records,
+                                                            uint32_t coreCount, uint64_t endTime) {
+    std::vector<std::vector<RunInterval>> intervals(coreCount);
+    std::vector<long long> open(coreCount, -1); // index into intervals[core] of the running slice
+
+    for (const auto& rec : records) {
+        if (rec.core < 0 || static_cast<uint32_t>(rec.core) >= coreCount) continue;
+        auto& core = intervals[rec.core];
+        auto event = static_cast<TraceEvent>(rec.event);
+
+        if (event == TraceEvent::Dispatch) {
+            if (open[rec.core] >= 0) core[open[rec.core]].end = rec.timeMicros;
+            core.push_back({rec.pid, rec.timeMicros, endTime});
+            open[rec.core] = static_cast<long long>(core.size()) - 1;
+        } else if (open[rec.core] >= 0 && core[open[rec.core]].pid == rec.pid) {
+            core[open[rec.core]].end = rec.timeMicros;
+            open[rec.core] = -1;
+        }
+    }
+    return intervals;
+}
+
+static void printGantt(const std::vector<std::vector<RunInterval>>& intervals, uint64_t endTime, int columns) {
+    double bucket = static_cast<double>(endTime) / columns;
+    std::cout << "Per-core timeline (" << std::fixed << std::setprecision(1) << bucket / 1000.0
+              << " ms per column)\n";
+
+    for (size_t core = 0; core < intervals.size(); ++core) {
+        std::string row(columns, '.');
+        std::vector<long long> owner(columns, -1);
+
+        for (const auto& slice : intervals[core]) {
+            int first = static_cast<int>(slice.begin / bucket);
+            int last = static_cast<int>(std::max(slice.begin, slice.end - (slice.end > 0 ? 1 : 0)) / bucket);
+            for (int col = std::max(0, first); col <= std::min(columns - 1, last); ++col) {
+                if (owner[col] == -1 || owner[col] == slice.pid) {
+                    owner[col] = slice.pid;
+                    row[col] = static_cast<char>('0' + slice.pid % 10);
+                } else {
+                    row[col] = '*';
+                }
+            }
+        }
+        std::cout << "Core " << std::setw(3) << core << " |" << row << "|\n";
+    }
+    std::cout << "\n";
+}
+
+static void printUtilization(const std::vector<std::vector<RunInterval>>& intervals, uint64_t endTime, int buckets) {
+    std::vector<double> busy(buckets, 0.0);
+    double width = static_cast<double>(endTime) / buckets;
+
+    for (const auto& core : intervals) {
+        for (const auto& slice : core) {
+            for (int b = 0; b < buckets; ++b) {
+                double lo = std::max(b * width, static_cast<double>(slice.begin));
+                double hi = std::min((b + 1) * width, static_cast<double>(slice.end));
+                if (hi > lo) busy[b] += hi - lo;
+            }
+        }
+    }
+
+    std::cout << "Utilization over time\n";
+    for (int b = 0; b < buckets; ++b) {
+        double percent = width > 0 ? 100.0 * busy[b] / (width * intervals.size()) : 0.0;
+        int bar = static_cast<int>(percent / 2);
+        std::cout << std::setw(8) << std::setprecision(1) << (b * width) / 1000.0 << " ms "
+                  << std::setw(5) << percent << "% " << std::string(bar, '#') << "\n";
+    }
+    std::cout << "\n";
+}
+
+static void printQueueingDelays(const std::vector<TraceRecord>& records) {
+    std::unordered_map<uint32_t, uint64_t> readySince;
+    std::vector<uint64_t> delays;
+
+    for (const auto& rec : records) {
+        auto event = static_cast<TraceEvent>(rec.event);
+        if (event == TraceEvent::Arrival || event == TraceEvent::Preempt || event == TraceEvent::Wake) {
+            readySince[rec.pid] = rec.timeMicros;
+        } else if (event == TraceEvent::Dispatch) {
+            auto it = readySince.find(rec.pid);
+            if (it != readySince.end()) {
+                delays.push_back(rec.timeMicros - it->second);
+                readySince.erase(it);
+            }
+        }
+    }
+
+    std::cout << "Queueing delay (ready -> dispatch), " << delays.size() << " samples\n";
+    if (delays.empty()) return;
+
+    std::sort(delays.begin(), delays.end());
+    auto percentile = [&](double p) { return delays[static_cast<size_t>(p * (delays.size() - 1))]; };
+    double mean = 0;
+    for (auto d : delays) mean += d;
+    mean /= delays.size();
+
+    std::cout << "  mean " << std::setprecision(1) << mean / 1000.0 << " ms, p50 " << percentile(0.5) / 1000.0
+              << " ms, p90 " << percentile(0.9) / 1000.0 << " ms, p99 " << percentile(0.99) / 1000.0
+              << " ms, max " << delays.back() / 1000.0 << " ms\n";
+
+    // power-of-two microsecond buckets
+    std::map<int, size_t> histogram;
+    for (auto d : delays) {
+        int bucket = 0;
+        while ((1ULL << bucket) <= d) ++bucket;
+        ++histogram[bucket];
+    }
+    for (const auto& [bucket, count] : histogram) {
+        unsigned long long upper = 1ULL << bucket;
+        int bar = static_cast<int>(60.0 * count / delays.size());
+        std::cout << "  < " << std::setw(10) << upper << " us " << std::setw(8) << count << " "
+                  << std::string(std::max(bar, 1), '#') << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: trace_analyzer <trace file> [columns]\n";
+        return 1;
+    }
+    int columns = argc >= 3 ? std::max(10, std::atoi(argv[2])) : 80;
+
+    TraceFileHeader header;
+    std::vector<TraceRecord> records;
+    if (!readTrace(argv[1], header, records)) {
+        std::cerr << "Could not read trace " << argv[1] << "\n";
+        return 1;
+    }
+
+    // buffers are dumped core by core; put everything back in time order
+    std::stable_sort(records.begin(), records.end(),
+                     [](const TraceRecord& a, const TraceRecord& b) { return a.timeMicros < b.timeMicros; });
+    uint64_t endTime = records.empty() ? 1 : std::max<uint64_t>(1, records.back().timeMicros);
+
+    std::map<uint8_t, size_t> counts;
+    for (const auto& rec : records) ++counts[rec.event];
+
+    std::cout << "Trace: " << header.coreCount << " cores, " << records.size() << " events ("
+              << header.droppedCount << " dropped), " << std::fixed << std::setprecision(1)
+              << endTime / 1000.0 << " ms\n";
+    for (const auto& [event, count] : counts) std::cout << "  " << eventName(event) << ": " << count << "\n";
+    std::cout << "\n";
+
+    auto intervals = buildIntervals(records, header.coreCount, endTime);
+    printGantt(intervals, endTime, columns);
+    printUtilization(intervals, endTime, 20);
+    printQueueingDelays(records);
+    return 0;
+}